@@ -0,0 +1,195 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the YUV to RGBA kernels of VideoColorConverter against
+// GstVideoConverter, which is the engine behind the videoconvert element.
+//
+// Usage: color_converter_benchmark [iterations]
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "video_color_converter.h"
+
+namespace {
+
+constexpr int kDefaultIterations = 50;
+
+struct Resolution {
+  const char* name;
+  guint width;
+  guint height;
+};
+
+constexpr Resolution kResolutions[] = {
+    {"720p", 1280, 720},
+    {"1080p", 1920, 1080},
+    {"4K", 3840, 2160},
+};
+
+constexpr GstVideoFormat kFormats[] = {
+    GST_VIDEO_FORMAT_I420,
+    GST_VIDEO_FORMAT_NV12,
+};
+
+constexpr VideoColorConverter::Kernel kKernels[] = {
+    VideoColorConverter::Kernel::kScalar,
+    VideoColorConverter::Kernel::kSse2,
+    VideoColorConverter::Kernel::kAvx2,
+};
+
+// A video frame backed by its own buffer. The frame stays mapped for the
+// lifetime of the object.
+class MappedFrame {
+ public:
+  MappedFrame(GstVideoFormat format, guint width, guint height) {
+    gst_video_info_set_format(&info_, format, width, height);
+    buffer_ = gst_buffer_new_allocate(nullptr, GST_VIDEO_INFO_SIZE(&info_),
+                                      nullptr);
+    is_mapped_ = gst_video_frame_map(
+        &frame_, &info_, buffer_,
+        static_cast<GstMapFlags>(GST_MAP_READ | GST_MAP_WRITE));
+  }
+  ~MappedFrame() {
+    if (is_mapped_) {
+      gst_video_frame_unmap(&frame_);
+    }
+    gst_buffer_unref(buffer_);
+  }
+
+  bool IsValid() const { return is_mapped_; }
+  GstVideoFrame* Get() { return &frame_; }
+  const GstVideoInfo* GetInfo() const { return &info_; }
+
+  void FillRandom(std::mt19937& engine) {
+    std::uniform_int_distribution<int> distribution(0, 255);
+    for (auto i = 0; i < GST_VIDEO_FRAME_N_PLANES(&frame_); i++) {
+      auto* data =
+          static_cast<uint8_t*>(GST_VIDEO_FRAME_PLANE_DATA(&frame_, i));
+      const auto stride = GST_VIDEO_FRAME_PLANE_STRIDE(&frame_, i);
+      const auto rows = (i == 0) ? GST_VIDEO_FRAME_HEIGHT(&frame_)
+                                 : (GST_VIDEO_FRAME_HEIGHT(&frame_) + 1) / 2;
+      for (auto j = 0; j < stride * rows; j++) {
+        data[j] = static_cast<uint8_t>(distribution(engine));
+      }
+    }
+  }
+
+ private:
+  GstVideoInfo info_;
+  GstVideoFrame frame_;
+  GstBuffer* buffer_ = nullptr;
+  bool is_mapped_ = false;
+};
+
+double MeasureMsPerFrame(int iterations, const std::function<void()>& run) {
+  // Warms up the caches before measuring.
+  run();
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < iterations; i++) {
+    run();
+  }
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+bool IsSameImage(GstVideoFrame* lhs, GstVideoFrame* rhs) {
+  const auto row_bytes = GST_VIDEO_FRAME_WIDTH(lhs) * 4;
+  for (auto y = 0; y < GST_VIDEO_FRAME_HEIGHT(lhs); y++) {
+    const auto* lhs_row = static_cast<const uint8_t*>(
+                              GST_VIDEO_FRAME_PLANE_DATA(lhs, 0)) +
+                          y * GST_VIDEO_FRAME_PLANE_STRIDE(lhs, 0);
+    const auto* rhs_row = static_cast<const uint8_t*>(
+                              GST_VIDEO_FRAME_PLANE_DATA(rhs, 0)) +
+                          y * GST_VIDEO_FRAME_PLANE_STRIDE(rhs, 0);
+    if (std::memcmp(lhs_row, rhs_row, row_bytes) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  gst_init(&argc, &argv);
+
+  auto iterations = kDefaultIterations;
+  if (argc > 1) {
+    iterations = std::max(1, std::atoi(argv[1]));
+  }
+
+  std::mt19937 engine(0);
+  auto has_mismatch = false;
+  for (const auto format : kFormats) {
+    for (const auto& resolution : kResolutions) {
+      MappedFrame src(format, resolution.width, resolution.height);
+      MappedFrame reference(GST_VIDEO_FORMAT_RGBA, resolution.width,
+                            resolution.height);
+      MappedFrame dest(GST_VIDEO_FORMAT_RGBA, resolution.width,
+                       resolution.height);
+      if (!src.IsValid() || !reference.IsValid() || !dest.IsValid()) {
+        std::cerr << "Failed to allocate frames for " << resolution.name
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      src.FillRandom(engine);
+
+      const auto label = std::string(gst_video_format_to_string(format)) +
+                         " " + resolution.name;
+
+      auto* converter =
+          gst_video_converter_new(src.GetInfo(), dest.GetInfo(), nullptr);
+      if (converter) {
+        const auto ms = MeasureMsPerFrame(iterations, [&]() {
+          gst_video_converter_frame(converter, src.Get(), dest.Get());
+        });
+        std::cout << label << " GstVideoConverter: " << ms << " ms/frame"
+                  << std::endl;
+        gst_video_converter_free(converter);
+      }
+
+      VideoColorConverter scalar(VideoColorConverter::Kernel::kScalar);
+      scalar.Convert(src.Get(),
+                     static_cast<uint8_t*>(
+                         GST_VIDEO_FRAME_PLANE_DATA(reference.Get(), 0)),
+                     GST_VIDEO_FRAME_PLANE_STRIDE(reference.Get(), 0));
+
+      for (const auto kernel : kKernels) {
+        if (!VideoColorConverter::IsKernelSupported(kernel)) {
+          std::cout << label << " "
+                    << VideoColorConverter::GetKernelName(kernel)
+                    << ": not supported" << std::endl;
+          continue;
+        }
+
+        VideoColorConverter color_converter(kernel);
+        auto* pixels =
+            static_cast<uint8_t*>(GST_VIDEO_FRAME_PLANE_DATA(dest.Get(), 0));
+        const auto stride = GST_VIDEO_FRAME_PLANE_STRIDE(dest.Get(), 0);
+        const auto ms = MeasureMsPerFrame(iterations, [&]() {
+          color_converter.Convert(src.Get(), pixels, stride);
+        });
+        const auto is_same = IsSameImage(dest.Get(), reference.Get());
+        has_mismatch |= !is_same;
+        std::cout << label << " "
+                  << VideoColorConverter::GetKernelName(kernel) << ": " << ms
+                  << " ms/frame" << (is_same ? "" : " (MISMATCH)")
+                  << std::endl;
+      }
+    }
+  }
+
+  return has_mismatch ? EXIT_FAILURE : EXIT_SUCCESS;
+}
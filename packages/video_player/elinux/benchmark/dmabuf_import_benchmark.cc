@@ -0,0 +1,249 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Exercises the dmabuf import path of USE_EGL_IMAGE_DMABUF on a render node,
+// such as Mesa with udmabuf, and measures the time to import a frame and to
+// find it in the cache. Frames are allocated with udmabuf from memfd, so no
+// decoder is needed. It checks that an image is imported once per memory and
+// context, and that it is destroyed together with its memory.
+//
+// Skipped without a DRM render node or /dev/udmabuf.
+//
+// Usage: dmabuf_import_benchmark [width] [height] [iterations]
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <fcntl.h>
+#include <gst/allocators/gstdmabuf.h>
+#include <gst/gl/egl/egl.h>
+#include <gst/gl/gl.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <linux/udmabuf.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "gst_dmabuf_image_cache.h"
+
+namespace {
+
+constexpr int kDefaultWidth = 1920;
+constexpr int kDefaultHeight = 1080;
+constexpr int kDefaultIterations = 100;
+// The number of buffers recycled by a typical decoder pool.
+constexpr int kBufferCount = 4;
+
+bool HasRenderNode() {
+  std::error_code error;
+  for (const auto& entry :
+       std::filesystem::directory_iterator("/dev/dri", error)) {
+    if (entry.path().filename().string().rfind("renderD", 0) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Allocates a dmabuf of |size| bytes filled with |value|, whose fd is owned by
+// the returned memory.
+GstMemory* AllocateDmabuf(GstAllocator* allocator, int udmabuf, size_t size,
+                          uint8_t value) {
+  const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size = (size + page_size - 1) / page_size * page_size;
+
+  const auto memfd =
+      memfd_create("dmabuf_import_benchmark", MFD_ALLOW_SEALING);
+  if (memfd < 0 || ftruncate(memfd, size) < 0 ||
+      fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK) < 0) {
+    std::cerr << "Failed to create a memfd" << std::endl;
+    if (memfd >= 0) {
+      close(memfd);
+    }
+    return nullptr;
+  }
+  auto* pixels = mmap(nullptr, size, PROT_WRITE, MAP_SHARED, memfd, 0);
+  if (pixels != MAP_FAILED) {
+    std::memset(pixels, value, size);
+    munmap(pixels, size);
+  }
+
+  struct udmabuf_create create = {};
+  create.memfd = memfd;
+  create.flags = UDMABUF_FLAGS_CLOEXEC;
+  create.offset = 0;
+  create.size = size;
+  const auto fd = ioctl(udmabuf, UDMABUF_CREATE, &create);
+  close(memfd);
+  if (fd < 0) {
+    std::cerr << "Failed to create a udmabuf" << std::endl;
+    return nullptr;
+  }
+  return gst_dmabuf_allocator_alloc(allocator, fd, size);
+}
+
+void OnImageFinalized(gpointer data, GstMiniObject* object) {
+  (*reinterpret_cast<int*>(data))++;
+}
+
+double ToMicroseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int width = argc > 1 ? std::atoi(argv[1]) : kDefaultWidth;
+  const int height = argc > 2 ? std::atoi(argv[2]) : kDefaultHeight;
+  const int iterations = argc > 3 ? std::atoi(argv[3]) : kDefaultIterations;
+  if (width <= 0 || height <= 0 || iterations <= 0) {
+    std::cerr << "Usage: " << argv[0] << " [width] [height] [iterations]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!HasRenderNode()) {
+    std::cout << "Skipped: no DRM render node" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  const auto udmabuf = open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+  if (udmabuf < 0) {
+    std::cout << "Skipped: /dev/udmabuf is not available" << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  // A surfaceless display and context, as the engine's are not needed to
+  // import images.
+  auto get_platform_display =
+      reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+          eglGetProcAddress("eglGetPlatformDisplayEXT"));
+  auto egl_display =
+      get_platform_display
+          ? get_platform_display(EGL_PLATFORM_SURFACELESS_MESA,
+                                 EGL_DEFAULT_DISPLAY, nullptr)
+          : EGL_NO_DISPLAY;
+  if (egl_display == EGL_NO_DISPLAY ||
+      !eglInitialize(egl_display, nullptr, nullptr)) {
+    std::cout << "Skipped: no surfaceless EGL display" << std::endl;
+    close(udmabuf);
+    return EXIT_SUCCESS;
+  }
+  eglBindAPI(EGL_OPENGL_ES_API);
+  const EGLint context_attributes[] = {EGL_CONTEXT_CLIENT_VERSION, 2,
+                                       EGL_NONE};
+  auto egl_context = eglCreateContext(egl_display, EGL_NO_CONFIG_KHR,
+                                      EGL_NO_CONTEXT, context_attributes);
+  if (egl_context == EGL_NO_CONTEXT ||
+      !eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                      egl_context)) {
+    std::cerr << "Failed to create a surfaceless EGL context" << std::endl;
+    eglTerminate(egl_display);
+    close(udmabuf);
+    return EXIT_FAILURE;
+  }
+
+  gst_init(&argc, &argv);
+  // Wrapped as GstVideoPlayer::UpdateGLContext does.
+  auto* gl_display = gst_gl_display_egl_new_with_egl_display(
+      reinterpret_cast<gpointer>(egl_display));
+  auto* gl_context = gst_gl_context_new_wrapped(
+      GST_GL_DISPLAY_CAST(gl_display), reinterpret_cast<guintptr>(egl_context),
+      GST_GL_PLATFORM_EGL, GST_GL_API_GLES2);
+  auto* other_gl_context = gst_gl_context_new_wrapped(
+      GST_GL_DISPLAY_CAST(gl_display), reinterpret_cast<guintptr>(egl_context),
+      GST_GL_PLATFORM_EGL, GST_GL_API_GLES2);
+  gst_gl_context_activate(gl_context, TRUE);
+
+  GstVideoInfo info;
+  gst_video_info_set_format(&info, GST_VIDEO_FORMAT_RGBA, width, height);
+  auto* allocator = gst_dmabuf_allocator_new();
+  std::vector<GstMemory*> memories;
+  for (int i = 0; i < kBufferCount; i++) {
+    auto* memory =
+        AllocateDmabuf(allocator, udmabuf, GST_VIDEO_INFO_SIZE(&info),
+                       static_cast<uint8_t>(i * 64));
+    if (!memory) {
+      break;
+    }
+    memories.push_back(memory);
+  }
+
+  auto is_passed = memories.size() == kBufferCount;
+  std::chrono::steady_clock::duration import_time{};
+  std::chrono::steady_clock::duration cached_time{};
+  int finalized_count = 0;
+  std::vector<GstEGLImage*> images;
+  for (auto* memory : memories) {
+    const auto start_time = std::chrono::steady_clock::now();
+    auto* image = GstDmabufImageCache::Import(gl_context, memory, info);
+    import_time += std::chrono::steady_clock::now() - start_time;
+    if (!image) {
+      is_passed = false;
+      break;
+    }
+    gst_mini_object_weak_ref(GST_MINI_OBJECT_CAST(image), OnImageFinalized,
+                             &finalized_count);
+    images.push_back(image);
+  }
+
+  // The recycled buffers are found in the cache.
+  for (int i = 0; is_passed && i < iterations; i++) {
+    const auto index = i % memories.size();
+    const auto start_time = std::chrono::steady_clock::now();
+    auto* image =
+        GstDmabufImageCache::Import(gl_context, memories[index], info);
+    cached_time += std::chrono::steady_clock::now() - start_time;
+    if (image != images[index]) {
+      std::cerr << "A cached image was imported again" << std::endl;
+      is_passed = false;
+    }
+  }
+
+  // Another context imports the image again, and the previous one is freed.
+  if (is_passed) {
+    auto* image =
+        GstDmabufImageCache::Import(other_gl_context, memories[0], info);
+    if (!image || image->context != other_gl_context || finalized_count != 1) {
+      std::cerr << "An image of another context was reused" << std::endl;
+      is_passed = false;
+    }
+  }
+
+  // The images are destroyed together with their memories.
+  for (auto* memory : memories) {
+    gst_memory_unref(memory);
+  }
+  if (is_passed && finalized_count != kBufferCount) {
+    std::cerr << "Cached images outlived their memories" << std::endl;
+    is_passed = false;
+  }
+
+  if (is_passed) {
+    std::cout << width << "x" << height << ": import "
+              << ToMicroseconds(import_time) / kBufferCount
+              << " us, cached " << ToMicroseconds(cached_time) / iterations
+              << " us" << std::endl;
+  }
+
+  gst_gl_context_activate(gl_context, FALSE);
+  gst_object_unref(allocator);
+  gst_object_unref(other_gl_context);
+  gst_object_unref(gl_context);
+  gst_object_unref(gl_display);
+  eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglDestroyContext(egl_display, egl_context);
+  eglTerminate(egl_display);
+  close(udmabuf);
+  gst_deinit();
+
+  std::cout << (is_passed ? "Passed" : "Failed") << std::endl;
+  return is_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,313 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Plays a video with GstVideoPlayer while a fake raster thread fetches frames
+// at the display rate, as the engine would, and reports the rendered frame
+// rate, the CPU time per frame, the copy bandwidth and the latency from
+// decoding a frame to displaying it. Runs without an engine or a GPU. A test
+// video is generated with videotestsrc if no uri is given.
+//
+// Usage: playback_throughput_benchmark [<uri>|-] [seconds] [display rate]
+
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gst_video_player.h"
+#include "video_player_stream_handler.h"
+
+namespace {
+
+constexpr int kDefaultSeconds = 10;
+constexpr int kDefaultDisplayRate = 60;
+constexpr auto kEventTimeout = std::chrono::seconds(10);
+
+// The generated video, encoded with the first encoder available.
+constexpr int kGeneratedFrameCount = 300;
+constexpr const char* kGeneratedEncoders[] = {
+    "x264enc speed-preset=ultrafast ! h264parse",
+    "vp8enc deadline=1",
+    "jpegenc",
+    // Raw frames if no encoder is installed.
+    "identity",
+};
+
+// Records when frames are decoded, and waits for the events of a player.
+class TimingStreamHandler : public VideoPlayerStreamHandler {
+ public:
+  TimingStreamHandler() = default;
+  ~TimingStreamHandler() = default;
+
+  bool WaitForInitialized() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, kEventTimeout,
+                        [this]() { return is_initialized_ || has_error_; }) &&
+           !has_error_;
+  }
+
+  // Returns the monotonic time in microseconds when the latest frame was
+  // decoded.
+  int64_t GetLastDecodedTime() const { return last_decoded_time_; }
+
+ protected:
+  // |VideoPlayerStreamHandler|
+  void OnNotifyInitializedInternal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_initialized_ = true;
+    cv_.notify_all();
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyFrameDecodedInternal() {
+    last_decoded_time_ = g_get_monotonic_time();
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyCompletedInternal() {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyBufferingStateChangedInternal(bool is_buffering) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlayingStateChangedInternal(bool is_playing) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlaylistItemChangedInternal(int32_t index) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlaybackRateChangedInternal(double rate,
+                                           const std::string& mode) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyResizedInternal(int32_t width, int32_t height) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyErrorInternal(const std::string& message) {
+    std::cerr << "Error: " << message << std::endl;
+    std::lock_guard<std::mutex> lock(mutex_);
+    has_error_ = true;
+    cv_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<int64_t> last_decoded_time_ = 0;
+  bool is_initialized_ = false;
+  bool has_error_ = false;
+};
+
+struct Result {
+  double fps = 0;
+  uint64_t decoded_frame_count = 0;
+  // CPU time of the whole process per rendered frame in milliseconds.
+  double cpu_time_per_frame = 0;
+  // Bytes copied or converted per second of copying, in MB/s.
+  double copy_bandwidth = 0;
+  // Latencies from decoding to displaying frames in milliseconds.
+  std::vector<double> latencies;
+};
+
+// Returns the user and system CPU time of the process in microseconds.
+int64_t GetCpuTime() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL +
+         usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+// Encodes a test video to |path|. Returns false if no encoder worked.
+bool GenerateVideo(const std::string& path) {
+  for (const auto* encoder : kGeneratedEncoders) {
+    const auto description =
+        "videotestsrc num-buffers=" + std::to_string(kGeneratedFrameCount) +
+        " pattern=ball ! video/x-raw,width=1920,height=1080,framerate=30/1 ! " +
+        encoder + " ! matroskamux ! filesink location=\"" + path + "\"";
+    GError* error = NULL;
+    auto* pipeline = gst_parse_launch(description.c_str(), &error);
+    if (error) {
+      g_error_free(error);
+      if (pipeline) {
+        gst_object_unref(pipeline);
+      }
+      continue;
+    }
+
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+    auto* bus = gst_element_get_bus(pipeline);
+    auto* message = gst_bus_timed_pop_filtered(
+        bus, GST_CLOCK_TIME_NONE,
+        static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+    const auto is_done =
+        message && GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS;
+    if (message) {
+      gst_message_unref(message);
+    }
+    gst_object_unref(bus);
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(pipeline);
+    if (is_done) {
+      std::cout << "Generated a test video with " << encoder << std::endl;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Measure(const std::string& uri, int seconds, int display_rate,
+             const GstVideoPlayer::Options& options, Result& result) {
+  auto handler = std::make_unique<TimingStreamHandler>();
+  auto* timing_handler = handler.get();
+  auto player =
+      std::make_unique<GstVideoPlayer>(uri, std::move(handler), options);
+  if (!timing_handler->WaitForInitialized()) {
+    std::cerr << "Failed to initialize the player" << std::endl;
+    return false;
+  }
+  player->SetAutoRepeat(true);
+  player->Play();
+
+  // Fetches frames on its own thread at the display rate, like the raster
+  // thread of the engine.
+  const auto interval = std::chrono::microseconds(1000000 / display_rate);
+  const auto start_time = std::chrono::steady_clock::now();
+  const auto end_time = start_time + std::chrono::seconds(seconds);
+  const auto start_cpu_time = GetCpuTime();
+  const auto start_stats = player->GetStats();
+  int32_t width = 0;
+  int32_t height = 0;
+  std::thread raster_thread([&]() {
+    auto next_time = start_time;
+    while (next_time < end_time) {
+      const auto rendered_count = player->GetRenderedFrameCount();
+      player->GetFrameBuffer(width, height);
+      if (player->GetRenderedFrameCount() != rendered_count) {
+        const auto latency =
+            g_get_monotonic_time() - timing_handler->GetLastDecodedTime();
+        result.latencies.push_back(latency / 1000.0);
+      }
+      player->ReleaseFrameBuffer();
+      next_time += interval;
+      std::this_thread::sleep_until(next_time);
+    }
+  });
+  raster_thread.join();
+
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start_time;
+  const auto cpu_time = GetCpuTime() - start_cpu_time;
+  const auto stats = player->GetStats();
+  const auto rendered_count =
+      stats.rendered_frame_count - start_stats.rendered_frame_count;
+  const auto copied_count =
+      stats.copied_frame_count - start_stats.copied_frame_count;
+  const auto copy_time = stats.copy_time - start_stats.copy_time;
+  result.fps = rendered_count / elapsed.count();
+  result.decoded_frame_count =
+      stats.decoded_frame_count - start_stats.decoded_frame_count;
+  if (rendered_count > 0) {
+    result.cpu_time_per_frame = cpu_time / 1000.0 / rendered_count;
+  }
+  if (copy_time > 0) {
+    // Bytes per microsecond are MB per second.
+    result.copy_bandwidth =
+        static_cast<double>(copied_count) * width * height * 4 / copy_time;
+  }
+  return rendered_count > 0;
+}
+
+double GetPercentile(const std::vector<double>& sorted, double percentile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto index = static_cast<size_t>(percentile / 100 * sorted.size());
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void PrintResult(const std::string& label, Result result) {
+  std::sort(result.latencies.begin(), result.latencies.end());
+  std::cout << label << ": fps = " << result.fps
+            << " (decoded = " << result.decoded_frame_count
+            << "), cpu = " << result.cpu_time_per_frame
+            << " ms/frame, copy = " << result.copy_bandwidth
+            << " MB/s, latency p50 = " << GetPercentile(result.latencies, 50)
+            << " ms, p90 = " << GetPercentile(result.latencies, 90)
+            << " ms, p99 = " << GetPercentile(result.latencies, 99) << " ms"
+            << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string uri;
+  if (argc > 1 && std::string(argv[1]) != "-") {
+    uri = argv[1];
+  }
+  auto seconds = kDefaultSeconds;
+  if (argc > 2) {
+    seconds = std::max(1, std::atoi(argv[2]));
+  }
+  auto display_rate = kDefaultDisplayRate;
+  if (argc > 3) {
+    display_rate = std::max(1, std::atoi(argv[3]));
+  }
+
+  GstVideoPlayer::GstLibraryLoad();
+  auto result = EXIT_SUCCESS;
+  std::string generated_path;
+  if (uri.empty()) {
+    auto* path = g_build_filename(g_get_tmp_dir(),
+                                  "video_player_elinux_benchmark.mkv", NULL);
+    generated_path = path;
+    g_free(path);
+    if (!GenerateVideo(generated_path)) {
+      std::cerr << "Failed to generate a test video" << std::endl;
+      GstVideoPlayer::GstLibraryUnload();
+      return EXIT_FAILURE;
+    }
+    uri = generated_path;
+  }
+
+  struct Configuration {
+    const char* label;
+    GstVideoPlayer::Options options;
+  };
+  std::vector<Configuration> configurations(4);
+  configurations[0].label = "Copy";
+  configurations[0].options.zero_copy = false;
+  configurations[1].label = "Zero copy";
+  configurations[2].label = "YUV conversion";
+  configurations[2].options.yuv_conversion = true;
+  configurations[3].label = "Appsink";
+  configurations[3].options.output_mode = GstVideoPlayer::OutputMode::kAppSink;
+  for (const auto& configuration : configurations) {
+    Result measured;
+    if (!Measure(uri, seconds, display_rate, configuration.options,
+                 measured)) {
+      std::cerr << configuration.label << ": failed to play" << std::endl;
+      result = EXIT_FAILURE;
+      continue;
+    }
+    PrintResult(configuration.label, measured);
+  }
+
+  if (!generated_path.empty()) {
+    g_remove(generated_path.c_str());
+  }
+  GstVideoPlayer::GstLibraryUnload();
+
+  return result;
+}
@@ -0,0 +1,187 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the latency from creating a GstVideoPlayer to its first rendered
+// frame, with and without GstVideoPipelinePool.
+//
+// Usage: player_creation_benchmark <uri> [iterations]
+
+#include <gst/gst.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gst_video_pipeline_pool.h"
+#include "gst_video_player.h"
+#include "video_player_stream_handler.h"
+
+namespace {
+
+constexpr int kDefaultIterations = 20;
+constexpr auto kFrameTimeout = std::chrono::seconds(10);
+
+// Waits for the events of a player.
+class WaitingStreamHandler : public VideoPlayerStreamHandler {
+ public:
+  WaitingStreamHandler() = default;
+  ~WaitingStreamHandler() = default;
+
+  bool WaitForInitialized() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, kFrameTimeout,
+                        [this]() { return is_initialized_ || has_error_; }) &&
+           !has_error_;
+  }
+
+  bool WaitForFrame() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, kFrameTimeout,
+                        [this]() { return has_frame_ || has_error_; }) &&
+           !has_error_;
+  }
+
+ protected:
+  // |VideoPlayerStreamHandler|
+  void OnNotifyInitializedInternal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_initialized_ = true;
+    cv_.notify_all();
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyFrameDecodedInternal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    has_frame_ = true;
+    cv_.notify_all();
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyCompletedInternal() {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyBufferingStateChangedInternal(bool is_buffering) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlayingStateChangedInternal(bool is_playing) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlaylistItemChangedInternal(int32_t index) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlaybackRateChangedInternal(double rate,
+                                           const std::string& mode) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyResizedInternal(int32_t width, int32_t height) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyErrorInternal(const std::string& message) {
+    std::cerr << "Error: " << message << std::endl;
+    std::lock_guard<std::mutex> lock(mutex_);
+    has_error_ = true;
+    cv_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool is_initialized_ = false;
+  bool has_frame_ = false;
+  bool has_error_ = false;
+};
+
+// Returns the latency of each iteration in milliseconds, or an empty list on
+// failure.
+std::vector<double> Measure(const std::string& uri, int iterations,
+                            const GstVideoPlayer::Options& options) {
+  std::vector<double> latencies;
+  for (auto i = 0; i < iterations; i++) {
+    auto handler = std::make_unique<WaitingStreamHandler>();
+    auto* waiting_handler = handler.get();
+
+    const auto start = std::chrono::steady_clock::now();
+    auto player =
+        std::make_unique<GstVideoPlayer>(uri, std::move(handler), options);
+    if (!waiting_handler->WaitForInitialized()) {
+      std::cerr << "Failed to initialize the player" << std::endl;
+      return {};
+    }
+    player->Play();
+    if (!waiting_handler->WaitForFrame()) {
+      std::cerr << "Failed to render a frame" << std::endl;
+      return {};
+    }
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    latencies.push_back(elapsed.count());
+
+    // Returns the pipeline to the pool if any.
+    player = nullptr;
+  }
+  return latencies;
+}
+
+void PrintLatencies(const std::string& label, std::vector<double> latencies) {
+  std::sort(latencies.begin(), latencies.end());
+  auto sum = 0.0;
+  for (const auto latency : latencies) {
+    sum += latency;
+  }
+  std::cout << label << ": mean = " << sum / latencies.size()
+            << " ms, median = " << latencies[latencies.size() / 2]
+            << " ms, max = " << latencies.back() << " ms" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <uri> [iterations]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string uri(argv[1]);
+  auto iterations = kDefaultIterations;
+  if (argc > 2) {
+    iterations = std::max(1, std::atoi(argv[2]));
+  }
+
+  GstVideoPlayer::GstLibraryLoad();
+  auto result = EXIT_SUCCESS;
+  {
+    GstVideoPlayer::Options options;
+    const auto latencies = Measure(uri, iterations, options);
+    if (latencies.empty()) {
+      result = EXIT_FAILURE;
+    } else {
+      PrintLatencies("Without pool", latencies);
+    }
+  }
+
+  {
+    GstVideoPipelinePool pool;
+    pool.SetCapacity(1);
+    GstVideoPlayer::Options options;
+    options.pipeline_pool = &pool;
+    GstVideoPlayer::PrewarmPipelines(options, 1);
+    const auto latencies = Measure(uri, iterations, options);
+    if (latencies.empty()) {
+      result = EXIT_FAILURE;
+    } else {
+      PrintLatencies("With pool", latencies);
+    }
+    const auto stats = pool.GetStats();
+    std::cout << "Pool hits = " << stats.hit_count
+              << ", misses = " << stats.miss_count << std::endl;
+  }
+  GstVideoPlayer::GstLibraryUnload();
+
+  return result;
+}
@@ -0,0 +1,205 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Plays a playlist with GstVideoPlayer and measures the gap between the last
+// frame of each item and the first frame of the next one, compared with the
+// usual interval between frames.
+//
+// Usage: playlist_gap_benchmark <uri> <uri> [<uri>...]
+
+#include <gst/gst.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gst_video_player.h"
+#include "video_player_stream_handler.h"
+
+namespace {
+
+constexpr auto kEventTimeout = std::chrono::seconds(10);
+
+// Records the time of each rendered frame and of each item change.
+class RecordingStreamHandler : public VideoPlayerStreamHandler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  RecordingStreamHandler() = default;
+  ~RecordingStreamHandler() = default;
+
+  bool WaitForInitialized() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, kEventTimeout,
+                        [this]() { return is_initialized_ || has_error_; }) &&
+           !has_error_;
+  }
+
+  // Waits until the last item has been played. Each item must start within
+  // |timeout| of the previous item changing.
+  bool WaitForCompleted(std::chrono::seconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto changes = item_changes_.size();
+    while (!is_completed_ && !has_error_) {
+      if (!cv_.wait_for(lock, timeout, [this, changes]() {
+            return is_completed_ || has_error_ ||
+                   item_changes_.size() != changes;
+          })) {
+        return false;
+      }
+      changes = item_changes_.size();
+    }
+    return !has_error_;
+  }
+
+  // Returns the gap of each item change in milliseconds.
+  std::vector<double> GetGaps() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<double> gaps;
+    for (const auto& change : item_changes_) {
+      // The first frame of the new item follows the change.
+      const auto next = std::lower_bound(frame_times_.begin(),
+                                         frame_times_.end(), change.time);
+      if (next == frame_times_.begin() || next == frame_times_.end()) {
+        continue;
+      }
+      const std::chrono::duration<double, std::milli> gap = *next - *(next - 1);
+      gaps.push_back(gap.count());
+    }
+    return gaps;
+  }
+
+  // Returns the median interval between frames in milliseconds.
+  double GetMedianFrameInterval() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<double> intervals;
+    for (size_t i = 1; i < frame_times_.size(); i++) {
+      const std::chrono::duration<double, std::milli> interval =
+          frame_times_[i] - frame_times_[i - 1];
+      intervals.push_back(interval.count());
+    }
+    if (intervals.empty()) {
+      return 0;
+    }
+    std::nth_element(intervals.begin(),
+                     intervals.begin() + intervals.size() / 2,
+                     intervals.end());
+    return intervals[intervals.size() / 2];
+  }
+
+ protected:
+  // |VideoPlayerStreamHandler|
+  void OnNotifyInitializedInternal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_initialized_ = true;
+    cv_.notify_all();
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyFrameDecodedInternal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frame_times_.push_back(Clock::now());
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyCompletedInternal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_completed_ = true;
+    cv_.notify_all();
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyBufferingStateChangedInternal(bool is_buffering) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlayingStateChangedInternal(bool is_playing) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlaylistItemChangedInternal(int32_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    item_changes_.push_back({index, Clock::now()});
+    cv_.notify_all();
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlaybackRateChangedInternal(double rate,
+                                           const std::string& mode) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyResizedInternal(int32_t width, int32_t height) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyErrorInternal(const std::string& message) {
+    std::cerr << "Error: " << message << std::endl;
+    std::lock_guard<std::mutex> lock(mutex_);
+    has_error_ = true;
+    cv_.notify_all();
+  }
+
+ private:
+  struct ItemChange {
+    int32_t index;
+    Clock::time_point time;
+  };
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Clock::time_point> frame_times_;
+  std::vector<ItemChange> item_changes_;
+  bool is_initialized_ = false;
+  bool is_completed_ = false;
+  bool has_error_ = false;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <uri> <uri> [<uri>...]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  GstVideoPlayer::Options options;
+  for (auto i = 2; i < argc; i++) {
+    options.playlist.push_back(argv[i]);
+  }
+
+  GstVideoPlayer::GstLibraryLoad();
+  auto result = EXIT_FAILURE;
+  {
+    auto handler = std::make_unique<RecordingStreamHandler>();
+    auto* recording_handler = handler.get();
+    auto player =
+        std::make_unique<GstVideoPlayer>(argv[1], std::move(handler), options);
+    if (!recording_handler->WaitForInitialized()) {
+      std::cerr << "Failed to initialize the player" << std::endl;
+    } else {
+      player->Play();
+      // An item may be as long as it likes, so wait generously per item.
+      if (!recording_handler->WaitForCompleted(std::chrono::seconds(600))) {
+        std::cerr << "Failed to play the playlist" << std::endl;
+      } else {
+        const auto gaps = recording_handler->GetGaps();
+        for (size_t i = 0; i < gaps.size(); i++) {
+          std::cout << "Item " << i + 1 << ": gap = " << gaps[i] << " ms"
+                    << std::endl;
+        }
+        std::cout << "Median frame interval = "
+                  << recording_handler->GetMedianFrameInterval() << " ms"
+                  << std::endl;
+        result = EXIT_SUCCESS;
+      }
+    }
+  }
+  GstVideoPlayer::GstLibraryUnload();
+
+  return result;
+}
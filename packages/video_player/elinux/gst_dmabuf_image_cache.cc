@@ -0,0 +1,46 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gst_dmabuf_image_cache.h"
+
+#include <gst/allocators/gstdmabuf.h>
+
+#include <iostream>
+
+namespace {
+// The key of the EGLImage cached on a GstMemory.
+GQuark GetEGLImageQuark() {
+  static const auto quark =
+      g_quark_from_static_string("GstVideoPlayerEGLImage");
+  return quark;
+}
+}  // namespace
+
+// static
+GstEGLImage* GstDmabufImageCache::Import(GstGLContext* context,
+                                         GstMemory* memory,
+                                         const GstVideoInfo& info) {
+  if (!gst_is_dmabuf_memory(memory)) {
+    return NULL;
+  }
+
+  // An image imported with a previous context is imported again.
+  auto* memory_object = GST_MINI_OBJECT_CAST(memory);
+  auto* egl_image = reinterpret_cast<GstEGLImage*>(
+      gst_mini_object_get_qdata(memory_object, GetEGLImageQuark()));
+  if (egl_image && egl_image->context == context) {
+    return egl_image;
+  }
+
+  gint fd = gst_dmabuf_memory_get_fd(memory);
+  egl_image = gst_egl_image_from_dmabuf(context, fd, &info, 0, 0);
+  if (!egl_image) {
+    std::cerr << "Failed to import a dmabuf as an EGLImage" << std::endl;
+    return NULL;
+  }
+  gst_mini_object_set_qdata(
+      memory_object, GetEGLImageQuark(), egl_image,
+      reinterpret_cast<GDestroyNotify>(gst_mini_object_unref));
+  return egl_image;
+}
@@ -0,0 +1,26 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_DMABUF_IMAGE_CACHE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_DMABUF_IMAGE_CACHE_H_
+
+#include <gst/gl/egl/egl.h>
+#include <gst/gl/gl.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+// Imports dmabufs as EGLImages, which are cached as qdata on the GstMemory of
+// each dmabuf as glupload does. Decoders recycle a small pool of buffers, so
+// steady playback creates no EGL objects. The cache holds no reference to the
+// memory, so a cached image is destroyed together with its memory.
+class GstDmabufImageCache {
+ public:
+  // Returns the image of the dmabuf |memory| holding a frame of |info|, which
+  // is imported only if it isn't cached for |context| yet. The image is owned
+  // by |memory|. Returns NULL if the import fails.
+  static GstEGLImage* Import(GstGLContext* context, GstMemory* memory,
+                             const GstVideoInfo& info);
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_DMABUF_IMAGE_CACHE_H_
@@ -0,0 +1,133 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gst_seek_scheduler.h"
+
+#include <utility>
+
+namespace {
+// Seeks requested within this time of the previous one are part of a scrub.
+constexpr auto kScrubInterval = std::chrono::milliseconds(200);
+// A seek whose ASYNC_DONE doesn't arrive within this time, e.g. on a live
+// source, is considered finished.
+constexpr auto kSeekTimeout = std::chrono::seconds(1);
+}  // namespace
+
+GstSeekScheduler::GstSeekScheduler(SeekCallback seek, bool accurate)
+    : seek_(std::move(seek)), accurate_(accurate) {}
+
+GstSeekScheduler::~GstSeekScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void GstSeekScheduler::Request(int64_t position) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = Clock::now();
+    is_pending_scrub_ =
+        is_in_flight_ || now - requested_time_ < kScrubInterval;
+    requested_time_ = now;
+    pending_position_ = position;
+
+    // Most players never seek, so the thread is started by the first seek.
+    if (!thread_.joinable()) {
+      thread_ = std::thread(&GstSeekScheduler::Run, this);
+    }
+  }
+  cv_.notify_all();
+}
+
+void GstSeekScheduler::OnAsyncDone(guint32 seqnum) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_in_flight_ || seqnum != in_flight_seqnum_) {
+      return;
+    }
+    is_in_flight_ = false;
+  }
+  cv_.notify_all();
+}
+
+void GstSeekScheduler::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!is_stopped_) {
+    int64_t position;
+    GstSeekFlags flags;
+    Clock::time_point deadline;
+    if (!TakeNextSeek(position, flags, deadline)) {
+      if (deadline == Clock::time_point::max()) {
+        cv_.wait(lock);
+      } else {
+        cv_.wait_until(lock, deadline);
+      }
+      continue;
+    }
+
+    // Set before seeking, as ASYNC_DONE may be posted before it returns.
+    const auto seqnum = gst_util_seqnum_next();
+    is_in_flight_ = true;
+    in_flight_seqnum_ = seqnum;
+    issued_time_ = Clock::now();
+    // Seeking waits for the streaming threads, which may call OnAsyncDone.
+    lock.unlock();
+    const auto is_issued = seek_(position, flags, seqnum);
+    lock.lock();
+    if (!is_issued) {
+      is_in_flight_ = false;
+    }
+  }
+}
+
+bool GstSeekScheduler::TakeNextSeek(int64_t& position, GstSeekFlags& flags,
+                                    Clock::time_point& deadline) {
+  const auto now = Clock::now();
+  deadline = Clock::time_point::max();
+  if (is_in_flight_) {
+    if (now - issued_time_ < kSeekTimeout) {
+      deadline = issued_time_ + kSeekTimeout;
+      return false;
+    }
+    is_in_flight_ = false;
+  }
+
+  if (pending_position_ >= 0) {
+    position = pending_position_;
+    pending_position_ = -1;
+    if (!accurate_) {
+      flags = static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH |
+                                        GST_SEEK_FLAG_KEY_UNIT);
+    } else if (is_pending_scrub_) {
+      flags = static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH |
+                                        GST_SEEK_FLAG_KEY_UNIT |
+                                        GST_SEEK_FLAG_SNAP_NEAREST);
+      final_position_ = position;
+    } else {
+      flags = static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH |
+                                        GST_SEEK_FLAG_ACCURATE);
+      final_position_ = -1;
+    }
+    return true;
+  }
+
+  if (final_position_ >= 0) {
+    // Waits for the scrub to settle.
+    if (now - requested_time_ < kScrubInterval) {
+      deadline = requested_time_ + kScrubInterval;
+      return false;
+    }
+    position = final_position_;
+    final_position_ = -1;
+    flags = static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH |
+                                      GST_SEEK_FLAG_ACCURATE);
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,76 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_SEEK_SCHEDULER_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_SEEK_SCHEDULER_H_
+
+#include <gst/gst.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Coalesces the seeks requested while scrubbing. Only one flushing seek is in
+// flight at a time, and the latest of the seeks requested meanwhile is issued
+// once the pipeline has finished the previous one.
+//
+// In the accurate mode, seeks requested in quick succession snap to the
+// nearest keyframe, and an accurate seek to the last requested position is
+// issued once no seek has been requested for a while. A single seek is
+// accurate right away.
+class GstSeekScheduler {
+ public:
+  // Seeks to |position| in milliseconds with |flags| by a seek event whose
+  // sequence number is |seqnum|. Returns false if the seek couldn't be issued.
+  using SeekCallback = std::function<bool(int64_t position, GstSeekFlags flags,
+                                          guint32 seqnum)>;
+
+  GstSeekScheduler(SeekCallback seek, bool accurate);
+  ~GstSeekScheduler();
+
+  // Prevent copying.
+  GstSeekScheduler(GstSeekScheduler const&) = delete;
+  GstSeekScheduler& operator=(GstSeekScheduler const&) = delete;
+
+  // Requests a seek to |position| in milliseconds without waiting for it.
+  void Request(int64_t position);
+
+  // Must be called when the pipeline posts ASYNC_DONE, including the one
+  // finishing the preroll. It finishes the seek in flight if |seqnum|, the
+  // sequence number of the message, is the one of its seek event.
+  void OnAsyncDone(guint32 seqnum);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  void Run();
+  // Returns the flags and the position of the next seek, or false if no seek
+  // can be issued yet. |deadline| is set to the time to check again.
+  bool TakeNextSeek(int64_t& position, GstSeekFlags& flags,
+                    Clock::time_point& deadline);
+
+  SeekCallback seek_;
+  const bool accurate_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool is_stopped_ = false;
+  // The latest requested position not issued yet, or -1.
+  int64_t pending_position_ = -1;
+  bool is_pending_scrub_ = false;
+  // The position of the accurate seek following a scrub, or -1.
+  int64_t final_position_ = -1;
+  bool is_in_flight_ = false;
+  // The sequence number of the seek in flight. Seeks not issued by the
+  // scheduler, such as the ones changing the playback rate, post ASYNC_DONE
+  // with other numbers.
+  guint32 in_flight_seqnum_ = GST_SEQNUM_INVALID;
+  Clock::time_point issued_time_;
+  Clock::time_point requested_time_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_SEEK_SCHEDULER_H_
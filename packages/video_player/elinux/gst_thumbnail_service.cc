@@ -0,0 +1,443 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gst_thumbnail_service.h"
+
+#include <gst/app/app.h>
+#include <gst/video/video.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+// More parallel decoders mostly compete with the players for the CPU and the
+// hardware decoders.
+constexpr size_t kMaxDefaultWorkerCount = 4;
+
+// The time allowed for prerolling, seeking and converting a frame.
+constexpr GstClockTime kPipelineTimeout = 10 * GST_SECOND;
+
+// The header of the cache files, followed by the cache key, the size of the
+// thumbnail and its data.
+constexpr char kCacheFileMagic[] = "VPTH";
+
+const char* GetFormatName(GstThumbnailService::Format format) {
+  switch (format) {
+    case GstThumbnailService::Format::kRgba:
+      return "rgba";
+    case GstThumbnailService::Format::kPng:
+      return "png";
+    case GstThumbnailService::Format::kJpeg:
+      return "jpeg";
+  }
+  return "";
+}
+
+// Links only the first video stream of uridecodebin to the appsink.
+void HandlePadAdded(GstElement* decodebin, GstPad* pad, gpointer user_data) {
+  auto* sink = reinterpret_cast<GstElement*>(user_data);
+  auto* caps = gst_pad_get_current_caps(pad);
+  if (!caps) {
+    caps = gst_pad_query_caps(pad, NULL);
+  }
+  const auto is_video = gst_structure_has_name(
+      gst_caps_get_structure(caps, 0), "video/x-raw");
+  gst_caps_unref(caps);
+  if (!is_video) {
+    return;
+  }
+
+  auto* sink_pad = gst_element_get_static_pad(sink, "sink");
+  if (!gst_pad_is_linked(sink_pad) &&
+      gst_pad_link(pad, sink_pad) != GST_PAD_LINK_OK) {
+    std::cerr << "Failed to link a video stream" << std::endl;
+  }
+  gst_object_unref(sink_pad);
+}
+
+// Returns the error posted by the pipeline, or |fallback| if none.
+std::string GetPipelineError(GstElement* pipeline, const char* fallback) {
+  std::string message(fallback);
+  auto* bus = gst_element_get_bus(pipeline);
+  auto* error_message = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+  if (error_message) {
+    GError* error;
+    gst_message_parse_error(error_message, &error, NULL);
+    message = std::string(GST_OBJECT_NAME(error_message->src)) + ": " +
+              error->message;
+    g_error_free(error);
+    gst_message_unref(error_message);
+  }
+  gst_object_unref(bus);
+  return message;
+}
+
+// Returns true if the pipeline finished changing its state in time.
+bool WaitForState(GstElement* pipeline) {
+  const auto result =
+      gst_element_get_state(pipeline, NULL, NULL, kPipelineTimeout);
+  return result == GST_STATE_CHANGE_SUCCESS ||
+         result == GST_STATE_CHANGE_NO_PREROLL;
+}
+
+// Returns the caps of the thumbnail of |sample|, scaled down to fit
+// |max_width| x |max_height| with square pixels.
+GstCaps* CreateThumbnailCaps(GstSample* sample,
+                             const GstThumbnailService::Request& request,
+                             int32_t& width, int32_t& height) {
+  GstVideoInfo info;
+  if (!gst_video_info_from_caps(&info, gst_sample_get_caps(sample))) {
+    return nullptr;
+  }
+
+  auto display_width = static_cast<double>(GST_VIDEO_INFO_WIDTH(&info));
+  const auto display_height = static_cast<double>(GST_VIDEO_INFO_HEIGHT(&info));
+  if (GST_VIDEO_INFO_PAR_N(&info) > 0 && GST_VIDEO_INFO_PAR_D(&info) > 0) {
+    display_width = display_width * GST_VIDEO_INFO_PAR_N(&info) /
+                    GST_VIDEO_INFO_PAR_D(&info);
+  }
+  auto scale = 1.0;
+  if (request.max_width > 0) {
+    scale = std::min(scale, request.max_width / display_width);
+  }
+  if (request.max_height > 0) {
+    scale = std::min(scale, request.max_height / display_height);
+  }
+  width = std::max(1, static_cast<int32_t>(std::lround(display_width * scale)));
+  height =
+      std::max(1, static_cast<int32_t>(std::lround(display_height * scale)));
+
+  switch (request.format) {
+    case GstThumbnailService::Format::kRgba:
+      return gst_caps_new_simple("video/x-raw", "format", G_TYPE_STRING,
+                                 "RGBA", "width", G_TYPE_INT, width, "height",
+                                 G_TYPE_INT, height, "pixel-aspect-ratio",
+                                 GST_TYPE_FRACTION, 1, 1, NULL);
+    case GstThumbnailService::Format::kPng:
+      return gst_caps_new_simple("image/png", "width", G_TYPE_INT, width,
+                                 "height", G_TYPE_INT, height, NULL);
+    case GstThumbnailService::Format::kJpeg:
+      return gst_caps_new_simple("image/jpeg", "width", G_TYPE_INT, width,
+                                 "height", G_TYPE_INT, height, NULL);
+  }
+  return nullptr;
+}
+}  // namespace
+
+GstThumbnailService::GstThumbnailService(size_t worker_count,
+                                         const std::string& cache_directory)
+    : worker_count_(std::max<size_t>(1, worker_count)),
+      cache_directory_(cache_directory) {
+  if (!cache_directory_.empty() &&
+      g_mkdir_with_parents(cache_directory_.c_str(), 0755) != 0) {
+    std::cerr << "Failed to create " << cache_directory_ << std::endl;
+  }
+}
+
+GstThumbnailService::~GstThumbnailService() {
+  std::deque<Job> jobs;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+    jobs.swap(jobs_);
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+
+  // The requests not started fail, so that every callback is called once.
+  for (auto& job : jobs) {
+    job.batch->results[job.index].error = "The thumbnail service is stopped";
+    if (--job.batch->remaining_count == 0) {
+      job.batch->callback(std::move(job.batch->results));
+    }
+  }
+}
+
+// static
+size_t GstThumbnailService::GetDefaultWorkerCount() {
+  return std::clamp<size_t>(std::thread::hardware_concurrency(), 1,
+                            kMaxDefaultWorkerCount);
+}
+
+void GstThumbnailService::Extract(std::vector<Request> requests,
+                                  Callback callback) {
+  if (requests.empty()) {
+    callback({});
+    return;
+  }
+
+  auto batch = std::make_shared<Batch>();
+  batch->results.resize(requests.size());
+  batch->remaining_count = requests.size();
+  batch->requests = std::move(requests);
+  batch->callback = std::move(callback);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < batch->requests.size(); i++) {
+      jobs_.push_back({batch, i});
+    }
+    // The workers are started by the first request, as most applications
+    // never ask for thumbnails.
+    while (workers_.size() < worker_count_) {
+      workers_.emplace_back(&GstThumbnailService::Run, this);
+    }
+  }
+  cv_.notify_all();
+}
+
+void GstThumbnailService::Run() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return is_stopped_ || !jobs_.empty(); });
+      if (is_stopped_) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+
+    auto result = Process(job.batch->requests[job.index]);
+    bool is_batch_done;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job.batch->results[job.index] = std::move(result);
+      is_batch_done = --job.batch->remaining_count == 0;
+    }
+    if (is_batch_done) {
+      job.batch->callback(std::move(job.batch->results));
+    }
+  }
+}
+
+GstThumbnailService::Result GstThumbnailService::Process(
+    const Request& request) {
+  const auto uri = ParseUri(request.uri);
+  const auto key = cache_directory_.empty() ? std::string()
+                                            : GetCacheKey(uri, request);
+  Result result;
+  if (!key.empty() && LoadFromCache(key, result)) {
+    return result;
+  }
+
+  result = ExtractFrame(uri, request);
+  if (!key.empty() && result.error.empty()) {
+    StoreToCache(key, result);
+  }
+  return result;
+}
+
+// static
+GstThumbnailService::Result GstThumbnailService::ExtractFrame(
+    const std::string& uri, const Request& request) {
+  Result result;
+  auto* pipeline = gst_pipeline_new(NULL);
+  auto* decodebin = gst_element_factory_make("uridecodebin", NULL);
+  auto* sink = gst_element_factory_make("appsink", NULL);
+  if (!pipeline || !decodebin || !sink) {
+    result.error = "Failed to create a pipeline";
+    for (auto* element : {pipeline, decodebin, sink}) {
+      if (element) {
+        gst_object_unref(element);
+      }
+    }
+    return result;
+  }
+
+  // Streams other than video are neither decoded nor exposed.
+  auto* video_caps = gst_caps_from_string("video/x-raw(ANY)");
+  g_object_set(G_OBJECT(decodebin), "uri", uri.c_str(), "caps", video_caps,
+               "expose-all-streams", FALSE, NULL);
+  gst_caps_unref(video_caps);
+  // Decoded frames are converted by gst_video_convert_sample, which needs
+  // them in system memory.
+  auto* sink_caps = gst_caps_from_string("video/x-raw");
+  g_object_set(G_OBJECT(sink), "caps", sink_caps, "sync", FALSE, NULL);
+  gst_caps_unref(sink_caps);
+  gst_bin_add_many(GST_BIN(pipeline), decodebin, sink, NULL);
+  g_signal_connect(decodebin, "pad-added", G_CALLBACK(HandlePadAdded), sink);
+
+  GstSample* sample = nullptr;
+  if (gst_element_set_state(pipeline, GST_STATE_PAUSED) ==
+          GST_STATE_CHANGE_FAILURE ||
+      !WaitForState(pipeline)) {
+    result.error = GetPipelineError(pipeline, "Failed to preroll");
+  } else if (request.position > 0 &&
+             (!gst_element_seek_simple(
+                  pipeline, GST_FORMAT_TIME,
+                  static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH |
+                                            GST_SEEK_FLAG_KEY_UNIT |
+                                            GST_SEEK_FLAG_SNAP_NEAREST),
+                  request.position * GST_MSECOND) ||
+              !WaitForState(pipeline))) {
+    result.error = GetPipelineError(pipeline, "Failed to seek");
+  } else {
+    sample = gst_app_sink_try_pull_preroll(GST_APP_SINK(sink), 0);
+    if (!sample) {
+      result.error = "No video frame";
+    }
+  }
+
+  if (sample) {
+    auto* caps = CreateThumbnailCaps(sample, request, result.width,
+                                     result.height);
+    GError* error = NULL;
+    auto* thumbnail =
+        caps ? gst_video_convert_sample(sample, caps, kPipelineTimeout, &error)
+             : nullptr;
+    if (thumbnail) {
+      GstMapInfo map;
+      auto* buffer = gst_sample_get_buffer(thumbnail);
+      if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+        result.data.assign(map.data, map.data + map.size);
+        gst_buffer_unmap(buffer, &map);
+      } else {
+        result.error = "Failed to map the thumbnail";
+      }
+      gst_sample_unref(thumbnail);
+    } else {
+      result.error = std::string("Failed to convert the frame") +
+                     (error ? std::string(": ") + error->message : "");
+    }
+    if (error) {
+      g_error_free(error);
+    }
+    if (caps) {
+      gst_caps_unref(caps);
+    }
+    gst_sample_unref(sample);
+  }
+
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(pipeline);
+  if (!result.error.empty()) {
+    std::cerr << "Failed to extract a thumbnail of " << uri << ": "
+              << result.error << std::endl;
+    result.width = 0;
+    result.height = 0;
+  }
+  return result;
+}
+
+// static
+std::string GstThumbnailService::ParseUri(const std::string& uri) {
+  if (gst_uri_is_valid(uri.c_str())) {
+    return uri;
+  }
+
+  auto* filename_uri = gst_filename_to_uri(uri.c_str(), NULL);
+  if (!filename_uri) {
+    return uri;
+  }
+  std::string result_uri(filename_uri);
+  g_free(filename_uri);
+  return result_uri;
+}
+
+// static
+std::string GstThumbnailService::GetCacheKey(const std::string& uri,
+                                             const Request& request) {
+  // Only local files can tell whether they have changed.
+  auto* filename = g_filename_from_uri(uri.c_str(), NULL, NULL);
+  if (!filename) {
+    return std::string();
+  }
+  struct stat file_stat;
+  const auto result = stat(filename, &file_stat);
+  g_free(filename);
+  if (result != 0) {
+    return std::string();
+  }
+
+  std::ostringstream key;
+  key << uri << '\n'
+      << file_stat.st_mtime << '.' << file_stat.st_mtim.tv_nsec << '\n'
+      << file_stat.st_size << '\n'
+      << request.position << '\n'
+      << request.max_width << 'x' << request.max_height << '\n'
+      << GetFormatName(request.format);
+  return key.str();
+}
+
+std::string GstThumbnailService::GetCachePath(const std::string& key) const {
+  std::ostringstream path;
+  path << cache_directory_ << '/' << std::hex << std::hash<std::string>()(key)
+       << ".thumbnail";
+  return path.str();
+}
+
+bool GstThumbnailService::LoadFromCache(const std::string& key,
+                                        Result& result) const {
+  std::ifstream file(GetCachePath(key), std::ios::binary);
+  if (!file) {
+    return false;
+  }
+
+  char magic[sizeof(kCacheFileMagic)] = {};
+  uint32_t key_size = 0;
+  file.read(magic, sizeof(kCacheFileMagic) - 1);
+  file.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+  if (!file || std::string(magic) != kCacheFileMagic ||
+      key_size != key.size()) {
+    return false;
+  }
+  // Files of other keys with the same hash are ignored.
+  std::string file_key(key_size, '\0');
+  file.read(&file_key[0], key_size);
+  if (!file || file_key != key) {
+    return false;
+  }
+
+  uint64_t data_size = 0;
+  file.read(reinterpret_cast<char*>(&result.width), sizeof(result.width));
+  file.read(reinterpret_cast<char*>(&result.height), sizeof(result.height));
+  file.read(reinterpret_cast<char*>(&data_size), sizeof(data_size));
+  if (!file) {
+    return false;
+  }
+  result.data.resize(data_size);
+  file.read(reinterpret_cast<char*>(result.data.data()), data_size);
+  return static_cast<bool>(file);
+}
+
+void GstThumbnailService::StoreToCache(const std::string& key,
+                                       const Result& result) const {
+  const auto path = GetCachePath(key);
+  // Written to a temporary file first, so that other workers never read a
+  // partial file.
+  std::ostringstream temporary_path;
+  temporary_path << path << '.' << std::this_thread::get_id();
+  {
+    std::ofstream file(temporary_path.str(), std::ios::binary);
+    const uint32_t key_size = key.size();
+    const uint64_t data_size = result.data.size();
+    file.write(kCacheFileMagic, sizeof(kCacheFileMagic) - 1);
+    file.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    file.write(key.data(), key.size());
+    file.write(reinterpret_cast<const char*>(&result.width),
+               sizeof(result.width));
+    file.write(reinterpret_cast<const char*>(&result.height),
+               sizeof(result.height));
+    file.write(reinterpret_cast<const char*>(&data_size), sizeof(data_size));
+    file.write(reinterpret_cast<const char*>(result.data.data()), data_size);
+    if (!file) {
+      std::cerr << "Failed to write " << temporary_path.str() << std::endl;
+      file.close();
+      std::remove(temporary_path.str().c_str());
+      return;
+    }
+  }
+  if (std::rename(temporary_path.str().c_str(), path.c_str()) != 0) {
+    std::cerr << "Failed to write " << path << std::endl;
+    std::remove(temporary_path.str().c_str());
+  }
+}
@@ -0,0 +1,109 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_THUMBNAIL_SERVICE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_THUMBNAIL_SERVICE_H_
+
+#include <gst/gst.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Extracts still frames of videos without creating players. Each frame is
+// decoded by a short-lived uridecodebin pipeline without any sink but an
+// appsink, and a bounded number of them run in parallel. Thumbnails of local
+// files are cached on disk, keyed by the modification time and the size of
+// the file.
+class GstThumbnailService {
+ public:
+  enum class Format {
+    // Raw RGBA pixels without padding.
+    kRgba,
+    kPng,
+    kJpeg,
+  };
+
+  struct Request {
+    std::string uri;
+    // The position of the frame in milliseconds. The nearest keyframe is
+    // taken.
+    int64_t position = 0;
+    // The thumbnail is scaled down to fit these, keeping the aspect ratio.
+    // Zero means unlimited.
+    int32_t max_width = 0;
+    int32_t max_height = 0;
+    Format format = Format::kPng;
+  };
+
+  struct Result {
+    // Empty on success.
+    std::string error;
+    int32_t width = 0;
+    int32_t height = 0;
+    std::vector<uint8_t> data;
+  };
+
+  // Called with the results in the order of the requests.
+  using Callback = std::function<void(std::vector<Result> results)>;
+
+  // Runs up to |worker_count| pipelines at a time. Thumbnails are cached in
+  // |cache_directory| unless it is empty.
+  GstThumbnailService(size_t worker_count, const std::string& cache_directory);
+  // Waits for the running requests, and fails the ones not started yet.
+  ~GstThumbnailService();
+
+  // Prevent copying.
+  GstThumbnailService(GstThumbnailService const&) = delete;
+  GstThumbnailService& operator=(GstThumbnailService const&) = delete;
+
+  // Returns the number of CPU cores, up to a limit which keeps the decoders
+  // from starving the players.
+  static size_t GetDefaultWorkerCount();
+
+  // Extracts the thumbnails of |requests| without waiting for them. |callback|
+  // is called on a worker thread once all of them are done, or on the thread
+  // destroying the service if it is destroyed first.
+  void Extract(std::vector<Request> requests, Callback callback);
+
+ private:
+  struct Batch {
+    std::vector<Request> requests;
+    std::vector<Result> results;
+    size_t remaining_count;
+    Callback callback;
+  };
+
+  struct Job {
+    std::shared_ptr<Batch> batch;
+    size_t index;
+  };
+
+  void Run();
+  Result Process(const Request& request);
+  static Result ExtractFrame(const std::string& uri, const Request& request);
+  static std::string ParseUri(const std::string& uri);
+  // Returns an empty key if the thumbnail can't be cached.
+  static std::string GetCacheKey(const std::string& uri,
+                                 const Request& request);
+  std::string GetCachePath(const std::string& key) const;
+  bool LoadFromCache(const std::string& key, Result& result) const;
+  void StoreToCache(const std::string& key, const Result& result) const;
+
+  const size_t worker_count_;
+  const std::string cache_directory_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Job> jobs_;
+  bool is_stopped_ = false;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_THUMBNAIL_SERVICE_H_
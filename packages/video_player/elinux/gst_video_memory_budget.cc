@@ -0,0 +1,154 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gst_video_memory_budget.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+// The players are checked at this interval, as their memory and visibility
+// change without notice.
+constexpr auto kUpdateInterval = std::chrono::seconds(1);
+
+// Players drawn within this time in microseconds are visible, and are never
+// suspended so that they don't freeze on the screen.
+constexpr int64_t kVisibleTimeout = 500000;
+
+// A degraded player is restored only if it fits in this ratio of the
+// remaining budget, so that it doesn't flip between levels.
+constexpr double kRestoreRatio = 0.9;
+}  // namespace
+
+GstVideoMemoryBudget::~GstVideoMemoryBudget() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void GstVideoMemoryBudget::SetBudget(size_t budget) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = budget;
+    // Updated by the thread, as degrading players changes their pipeline
+    // states, which must not block the caller.
+    is_update_requested_ = true;
+
+    // Without a budget nothing needs to be checked, so the thread is started
+    // by the first budget.
+    if (budget_ > 0 && !thread_.joinable()) {
+      thread_ = std::thread(&GstVideoMemoryBudget::Run, this);
+    }
+  }
+  cv_.notify_all();
+}
+
+size_t GstVideoMemoryBudget::GetBudget() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return budget_;
+}
+
+size_t GstVideoMemoryBudget::GetUsage() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t usage = 0;
+  for (auto* player : players_) {
+    usage += player->GetMemoryUsage();
+  }
+  return usage;
+}
+
+void GstVideoMemoryBudget::Add(GstVideoPlayer* player) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  players_.push_back(player);
+}
+
+void GstVideoMemoryBudget::Remove(GstVideoPlayer* player) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  players_.erase(std::remove(players_.begin(), players_.end(), player),
+                 players_.end());
+  // Waits for the level being applied to |player|, if any.
+  cv_.wait(lock, [this, player]() { return applying_player_ != player; });
+}
+
+void GstVideoMemoryBudget::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!is_stopped_) {
+    cv_.wait_for(lock, kUpdateInterval,
+                 [this]() { return is_stopped_ || is_update_requested_; });
+    is_update_requested_ = false;
+    if (is_stopped_) {
+      break;
+    }
+
+    // Changing a level may stop the loop playback, seek and change the
+    // pipeline state, so it is done without |mutex_|, which GetUsage and
+    // Remove take.
+    for (const auto& [player, level] : Update()) {
+      // Removed while the previous levels were applied.
+      if (is_stopped_ ||
+          std::find(players_.begin(), players_.end(), player) ==
+              players_.end()) {
+        continue;
+      }
+      applying_player_ = player;
+      lock.unlock();
+      player->SetMemoryLevel(level);
+      lock.lock();
+      applying_player_ = nullptr;
+      cv_.notify_all();
+    }
+  }
+}
+
+std::vector<GstVideoMemoryBudget::LevelChange> GstVideoMemoryBudget::Update() {
+  using MemoryLevel = GstVideoPlayer::MemoryLevel;
+  std::vector<LevelChange> changes;
+  if (budget_ == 0) {
+    for (auto* player : players_) {
+      changes.emplace_back(player, MemoryLevel::kNormal);
+    }
+    return changes;
+  }
+
+  // The most recently visible players get the budget first.
+  auto players = players_;
+  std::stable_sort(players.begin(), players.end(),
+                   [](GstVideoPlayer* a, GstVideoPlayer* b) {
+                     return a->GetLastVisibleTime() > b->GetLastVisibleTime();
+                   });
+
+  const auto now = g_get_monotonic_time();
+  size_t remaining = budget_;
+  for (auto* player : players) {
+    const auto current = player->GetMemoryLevel();
+    // Players still prerolling can't be suspended.
+    const auto can_suspend =
+        player->IsInitialized() &&
+        now - player->GetLastVisibleTime() > kVisibleTimeout;
+    auto level = MemoryLevel::kNormal;
+    while (true) {
+      const auto usage = player->EstimateMemoryUsage(level);
+      const auto available =
+          level < current ? static_cast<size_t>(remaining * kRestoreRatio)
+                          : remaining;
+      const auto is_last =
+          level == (can_suspend ? MemoryLevel::kSuspended
+                                : MemoryLevel::kReduced);
+      if (usage <= available || is_last) {
+        remaining -= std::min(usage, remaining);
+        break;
+      }
+      level = static_cast<MemoryLevel>(static_cast<int>(level) + 1);
+    }
+    if (level != current) {
+      changes.emplace_back(player, level);
+    }
+  }
+  return changes;
+}
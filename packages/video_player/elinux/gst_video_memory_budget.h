@@ -0,0 +1,63 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_MEMORY_BUDGET_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_MEMORY_BUDGET_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gst_video_player.h"
+
+// Keeps the estimated memory of the registered players within a budget. The
+// players are visited from the most recently visible one, and those which
+// don't fit are degraded: first their output resolution and network buffers
+// are reduced, then their decoding is suspended. Players which fit again are
+// restored.
+class GstVideoMemoryBudget {
+ public:
+  GstVideoMemoryBudget() = default;
+  ~GstVideoMemoryBudget();
+
+  // Prevent copying.
+  GstVideoMemoryBudget(GstVideoMemoryBudget const&) = delete;
+  GstVideoMemoryBudget& operator=(GstVideoMemoryBudget const&) = delete;
+
+  // Sets the budget in bytes. Zero means unlimited, which restores all
+  // players. The players are updated asynchronously.
+  void SetBudget(size_t budget);
+  size_t GetBudget();
+  // Returns the estimated memory of all players in bytes.
+  size_t GetUsage();
+
+  // Called by GstVideoPlayer when it is created and destroyed.
+  void Add(GstVideoPlayer* player);
+  void Remove(GstVideoPlayer* player);
+
+ private:
+  using LevelChange = std::pair<GstVideoPlayer*, GstVideoPlayer::MemoryLevel>;
+
+  void Run();
+  // Returns the memory levels to apply to the players. Must be called with
+  // |mutex_| held.
+  std::vector<LevelChange> Update();
+
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool is_stopped_ = false;
+  // Set by SetBudget to update the players without waiting for the interval.
+  bool is_update_requested_ = false;
+  size_t budget_ = 0;
+  std::vector<GstVideoPlayer*> players_;
+  // The player whose level is being applied without |mutex_| held, which
+  // Remove waits for.
+  GstVideoPlayer* applying_player_ = nullptr;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_MEMORY_BUDGET_H_
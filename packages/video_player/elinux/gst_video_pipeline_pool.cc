@@ -0,0 +1,112 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gst_video_pipeline_pool.h"
+
+#include <iterator>
+#include <vector>
+
+GstVideoPipelinePool::~GstVideoPipelinePool() { Clear(); }
+
+void GstVideoPipelinePool::SetCapacity(size_t capacity) {
+  std::vector<GstVideoElements> evicted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    // Evicts the least recently released pipelines first.
+    while (idle_pipelines_.size() > capacity_) {
+      evicted.push_back(idle_pipelines_.front().elements);
+      idle_pipelines_.pop_front();
+    }
+  }
+
+  // Destroys them outside the lock as the state change may take a while.
+  for (auto& elements : evicted) {
+    Destroy(elements);
+  }
+}
+
+size_t GstVideoPipelinePool::GetCapacity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+bool GstVideoPipelinePool::Acquire(const std::string& key,
+                                   GstVideoElements& elements) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto itr = idle_pipelines_.rbegin(); itr != idle_pipelines_.rend();
+       itr++) {
+    if (itr->key == key) {
+      elements = itr->elements;
+      idle_pipelines_.erase(std::next(itr).base());
+      hit_count_++;
+      return true;
+    }
+  }
+  miss_count_++;
+  return false;
+}
+
+bool GstVideoPipelinePool::Release(const std::string& key,
+                                   GstVideoElements& elements) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (idle_pipelines_.size() >= capacity_) {
+    return false;
+  }
+
+  idle_pipelines_.push_back({key, elements});
+  elements = GstVideoElements();
+  return true;
+}
+
+size_t GstVideoPipelinePool::GetIdleCount(const std::string& key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t count = 0;
+  for (const auto& entry : idle_pipelines_) {
+    if (entry.key == key) {
+      count++;
+    }
+  }
+  return count;
+}
+
+GstVideoPipelinePool::Stats GstVideoPipelinePool::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats;
+  stats.capacity = capacity_;
+  stats.idle_count = idle_pipelines_.size();
+  stats.hit_count = hit_count_;
+  stats.miss_count = miss_count_;
+  return stats;
+}
+
+void GstVideoPipelinePool::Clear() {
+  std::deque<Entry> idle_pipelines;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_pipelines.swap(idle_pipelines_);
+  }
+
+  for (auto& entry : idle_pipelines) {
+    Destroy(entry.elements);
+  }
+}
+
+// static
+void GstVideoPipelinePool::Destroy(GstVideoElements& elements) {
+  if (elements.pipeline) {
+    gst_element_set_state(elements.pipeline, GST_STATE_NULL);
+  }
+
+  if (elements.bus) {
+    gst_object_unref(elements.bus);
+  }
+
+  // The other elements are owned by the pipeline.
+  if (elements.pipeline) {
+    gst_object_unref(elements.pipeline);
+  }
+
+  elements = GstVideoElements();
+}
@@ -0,0 +1,88 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_PIPELINE_POOL_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_PIPELINE_POOL_H_
+
+#include <gst/gst.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+// The elements of a video pipeline built by GstVideoPlayer.
+struct GstVideoElements {
+  GstElement* pipeline = nullptr;
+  GstElement* playbin = nullptr;
+  GstElement* video_rate = nullptr;
+  GstElement* video_convert = nullptr;
+  GstElement* video_scale = nullptr;
+  GstElement* caps_filter = nullptr;
+  GstElement* video_sink = nullptr;
+  GstElement* output = nullptr;
+  GstBus* bus = nullptr;
+};
+
+// Keeps idle pipelines in the READY state, so that players can be created
+// without building pipelines and disposed without tearing them down.
+// Pipelines are only reused by players whose |key| is the same, which
+// describes how the pipeline was built.
+class GstVideoPipelinePool {
+ public:
+  struct Stats {
+    size_t capacity = 0;
+    size_t idle_count = 0;
+    // The number of Acquire calls which did or didn't find a pipeline.
+    uint64_t hit_count = 0;
+    uint64_t miss_count = 0;
+  };
+
+  GstVideoPipelinePool() = default;
+  ~GstVideoPipelinePool();
+
+  // Prevent copying.
+  GstVideoPipelinePool(GstVideoPipelinePool const&) = delete;
+  GstVideoPipelinePool& operator=(GstVideoPipelinePool const&) = delete;
+
+  // Sets the maximum number of idle pipelines. Idle pipelines over the new
+  // capacity are destroyed.
+  void SetCapacity(size_t capacity);
+  size_t GetCapacity() const;
+
+  // Moves an idle pipeline built for |key| into |elements|. Returns false if
+  // there is none.
+  bool Acquire(const std::string& key, GstVideoElements& elements);
+
+  // Keeps |elements|, which must be in the READY state and have no callbacks
+  // bound, for later use. Returns false if the pool is full, and the caller
+  // keeps the ownership in that case.
+  bool Release(const std::string& key, GstVideoElements& elements);
+
+  // Returns the number of idle pipelines built for |key|.
+  size_t GetIdleCount(const std::string& key) const;
+
+  Stats GetStats() const;
+
+  // Destroys all idle pipelines.
+  void Clear();
+
+  // Sets the state of the pipeline to NULL and releases all the elements.
+  static void Destroy(GstVideoElements& elements);
+
+ private:
+  struct Entry {
+    std::string key;
+    GstVideoElements elements;
+  };
+
+  mutable std::mutex mutex_;
+  size_t capacity_ = 0;
+  // The most recently released pipelines are at the back.
+  std::deque<Entry> idle_pipelines_;
+  uint64_t hit_count_ = 0;
+  uint64_t miss_count_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_PIPELINE_POOL_H_
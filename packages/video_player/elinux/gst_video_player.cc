@@ -4,42 +4,156 @@
 
 #include "gst_video_player.h"
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <utility>
+
+#ifdef USE_EGL_IMAGE_DMABUF
+#include "gst_dmabuf_image_cache.h"
+#endif  // USE_EGL_IMAGE_DMABUF
+#include "gst_video_memory_budget.h"
+
+namespace {
+// The appsink keeps only the latest sample so that memory and latency stay
+// bounded when the frames are not consumed in time.
+constexpr guint kAppSinkMaxBuffers = 1;
+
+constexpr char kRgbaCaps[] = "video/x-raw,format=RGBA";
+constexpr char kRgbaAndYuvCaps[] =
+    "video/x-raw,format=(string){RGBA,I420,NV12}";
+
+// The output size is renegotiated only when the requested size differs from
+// the current one by more than this ratio...
+constexpr double kOutputSizeHysteresis = 0.2;
+// ...and has stayed the same for this number of frames.
+constexpr int kOutputSizeStableFrames = 15;
+
+// Intervals between frames consumed by the texture are capped at this value
+// in microseconds, so that a pause doesn't drop the frames after it.
+constexpr gint64 kMaxConsumeInterval = 200000;
+
+// The engine releases a frame right after uploading it, so the destructor
+// waits for it only this long in case the texture was dropped meanwhile.
+constexpr std::chrono::milliseconds kFrameReleaseTimeout(1000);
+
+// The difference allowed between the cached and the queried positions in
+// milliseconds when Options::validate_position is enabled.
+constexpr int64_t kPositionValidationTolerance = 100;
+
+// Reverse playback faster than this rate plays only keyframes, as decoding
+// every frame backwards costs much more than decoding it forwards.
+constexpr double kMaxFullReverseRate = 1.0;
+constexpr int kReverseKeyUnitsFlags =
+    GST_SEEK_FLAG_TRICKMODE_KEY_UNITS | GST_SEEK_FLAG_TRICKMODE_NO_AUDIO;
+
+// How a playback rate is applied, as reported by
+// VideoPlayerStreamHandler::OnNotifyPlaybackRateChanged.
+constexpr char kPlaybackRateModeInstant[] = "instant";
+constexpr char kPlaybackRateModeFlush[] = "flush";
+constexpr char kPlaybackRateModeReverse[] = "reverse";
+constexpr char kPlaybackRateModeReverseKeyUnits[] = "reverseKeyUnits";
+
+// The frames estimated to be held by the frame exchange, and by the decoder
+// as references and in its queues.
+constexpr size_t kExchangedFrameCount = 3;
+constexpr size_t kDecoderFrameCount = 8;
+// The buffer size of network streams, which is the default of playbin, and
+// the size it is reduced to by MemoryLevel::kReduced.
+constexpr size_t kNetworkBufferSize = 2 * 1024 * 1024;
+constexpr gint kReducedNetworkBufferSize = 512 * 1024;
+
+bool IsOutsideHysteresis(int32_t current, int32_t requested) {
+  return std::abs(requested - current) > current * kOutputSizeHysteresis;
+}
+}  // namespace
 
 GstVideoPlayer::GstVideoPlayer(
-    const std::string& uri, std::unique_ptr<VideoPlayerStreamHandler> handler)
-    : stream_handler_(std::move(handler)) {
-  gst_.pipeline = nullptr;
-  gst_.playbin = nullptr;
-  gst_.video_convert = nullptr;
-  gst_.video_sink = nullptr;
-  gst_.output = nullptr;
-  gst_.bus = nullptr;
-  gst_.buffer = nullptr;
+    const std::string& uri, std::unique_ptr<VideoPlayerStreamHandler> handler,
+    const Options& options)
+    : options_(options), stream_handler_(std::move(handler)) {
+#ifdef USE_EGL_IMAGE_DMABUF
+  // EGLImages are imported from RGBA dmabufs, and are scaled by the GPU.
+  options_.yuv_conversion = false;
+  options_.adaptive_resolution = false;
+#endif  // USE_EGL_IMAGE_DMABUF
+  gst_video_info_init(&gst_video_info_);
+  gst_segment_init(&segment_, GST_FORMAT_TIME);
 
   uri_ = ParseUri(uri);
-  if (!CreatePipeline()) {
+  is_network_ = uri_.compare(0, 7, "file://") != 0;
+  last_visible_time_ = g_get_monotonic_time();
+  if (!options_.playlist.empty()) {
+    playlist_uris_.push_back(uri_);
+    for (const auto& item : options_.playlist) {
+      playlist_uris_.push_back(ParseUri(item));
+    }
+  }
+  if (options_.loop_cache_size > 0) {
+    loop_cache_ = std::make_unique<VideoLoopCache>(options_.loop_cache_size);
+  }
+  auto* pool = options_.pipeline_pool;
+  if (pool && pool->Acquire(GetPipelineKey(options_), gst_)) {
+    ResetPipeline();
+  } else if (!CreatePipeline(options_, gst_)) {
     std::cerr << "Failed to create a pipeline" << std::endl;
-    DestroyPipeline();
+    GstVideoPipelinePool::Destroy(gst_);
+    stream_handler_->OnNotifyError("Failed to create a pipeline for " + uri_);
     return;
   }
-
-  // Prerolls before getting information from the pipeline.
+  BindPipeline();
+  seek_scheduler_ = std::make_unique<GstSeekScheduler>(
+      [this](int64_t position, GstSeekFlags flags, guint32 seqnum) {
+        return Seek(position, flags, seqnum);
+      },
+      options_.accurate_seek);
+
+  // Information of the pipeline is got once it is prerolled.
   Preroll();
 
-  // Sets internal video size and buffier.
-  GetVideoSize(width_, height_);
-  pixels_.reset(new uint32_t[width_ * height_]);
-
-  stream_handler_->OnNotifyInitialized();
+  if (options_.memory_budget) {
+    options_.memory_budget->Add(this);
+  }
 }
 
 GstVideoPlayer::~GstVideoPlayer() {
+  // Waits for the running command, and answers the pending ones. The queue is
+  // taken first, as the bus handler posts restarts to it until the pipeline is
+  // destroyed.
+  std::unique_ptr<VideoCommandQueue> command_queue;
+  {
+    std::lock_guard<std::mutex> lock(mutex_command_queue_);
+    command_queue = std::move(command_queue_);
+  }
+  command_queue = nullptr;
+  // Waits for the budget to finish using this player.
+  if (options_.memory_budget) {
+    options_.memory_budget->Remove(this);
+  }
+  StopPrerollTimer();
+  // The loop thread pushes frames and notifies the handler.
+  StopLoopPlayback();
+  // The raster thread may still be uploading the mapped frame.
+  StopFrameDelivery();
+  UnmapFrame();
 #ifdef USE_EGL_IMAGE_DMABUF
   UnrefEGLImage();
 #endif  // USE_EGL_IMAGE_DMABUF
+  // Stops the streaming threads, and then the bus handler, which uses the
+  // seek scheduler.
   Stop();
+  UnbindPipeline();
+  // Waits for the seek in progress if any.
+  seek_scheduler_ = nullptr;
   DestroyPipeline();
+#ifdef USE_EGL_IMAGE_DMABUF
+  // The images cached on the memories of the pipeline are released above.
+  ReleaseGLContext();
+#endif  // USE_EGL_IMAGE_DMABUF
 }
 
 // static
@@ -49,6 +163,13 @@ void GstVideoPlayer::GstLibraryLoad() { gst_init(NULL, NULL); }
 void GstVideoPlayer::GstLibraryUnload() { gst_deinit(); }
 
 bool GstVideoPlayer::Play() {
+  SetLoopPaused(false);
+  std::lock_guard<std::mutex> lock(mutex_memory_level_);
+  if (memory_level_ == MemoryLevel::kSuspended) {
+    // Plays once restored.
+    resume_state_ = GST_STATE_PLAYING;
+    return true;
+  }
   if (gst_element_set_state(gst_.pipeline, GST_STATE_PLAYING) ==
       GST_STATE_CHANGE_FAILURE) {
     std::cerr << "Failed to change the state to PLAYING" << std::endl;
@@ -58,6 +179,12 @@ bool GstVideoPlayer::Play() {
 }
 
 bool GstVideoPlayer::Pause() {
+  SetLoopPaused(true);
+  std::lock_guard<std::mutex> lock(mutex_memory_level_);
+  if (memory_level_ == MemoryLevel::kSuspended) {
+    resume_state_ = GST_STATE_PAUSED;
+    return true;
+  }
   if (gst_element_set_state(gst_.pipeline, GST_STATE_PAUSED) ==
       GST_STATE_CHANGE_FAILURE) {
     std::cerr << "Failed to change the state to PAUSED" << std::endl;
@@ -90,39 +217,184 @@ bool GstVideoPlayer::SetPlaybackRate(double rate) {
     return false;
   }
 
-  if (rate <= 0) {
+  if (rate == 0) {
     std::cerr << "Rate " << rate << " is not supported" << std::endl;
     return false;
   }
 
-  auto position = GetCurrentPosition();
-  if (position < 0) {
-    return false;
-  }
+  const auto trick_mode_flags =
+      rate < -kMaxFullReverseRate ? kReverseKeyUnitsFlags : 0;
+  const auto is_same_direction = (rate > 0) == (playback_rate_ > 0);
+  const char* mode;
+  if (is_same_direction && trick_mode_flags == trick_mode_flags_ &&
+      ChangeRateInstantly(rate)) {
+    mode = kPlaybackRateModeInstant;
+  } else {
+    // Changing the direction or the trick mode needs a flushing seek, after
+    // which the pipeline plays again instead of the cached loop.
+    StopLoopPlayback();
+    if (loop_cache_) {
+      loop_cache_->AbortRecording();
+    }
+    auto position = GetCurrentPosition();
+    if (position < 0) {
+      return false;
+    }
 
-  if (!gst_element_seek(gst_.pipeline, rate, GST_FORMAT_TIME,
-                        GST_SEEK_FLAG_FLUSH, GST_SEEK_TYPE_SET,
-                        position * GST_MSECOND, GST_SEEK_TYPE_SET,
-                        GST_CLOCK_TIME_NONE)) {
-    std::cerr << "Failed to set playback rate to " << rate
-              << " (gst_element_seek failed)" << std::endl;
-    return false;
+    auto flags = static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH |
+                                           trick_mode_flags);
+    if (!Seek(rate, position, flags, gst_util_seqnum_next())) {
+      // Some demuxers and decoders can't decode backwards, but can still
+      // play keyframes backwards.
+      flags = static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH |
+                                        kReverseKeyUnitsFlags);
+      if (rate > 0 || trick_mode_flags ||
+          !Seek(rate, position, flags, gst_util_seqnum_next())) {
+        std::cerr << "Failed to set playback rate to " << rate
+                  << " (seek failed)" << std::endl;
+        return false;
+      }
+    }
+    trick_mode_flags_ = flags & kReverseKeyUnitsFlags;
+    if (rate > 0) {
+      mode = kPlaybackRateModeFlush;
+    } else if (trick_mode_flags_) {
+      mode = kPlaybackRateModeReverseKeyUnits;
+    } else {
+      mode = kPlaybackRateModeReverse;
+    }
   }
 
   playback_rate_ = rate;
+  UpdateMaxFrameRate();
   mute_ = (rate < 0.5 || rate > 2);
   g_object_set(gst_.playbin, "mute", mute_, NULL);
+  stream_handler_->OnNotifyPlaybackRateChanged(rate, mode);
 
   return true;
 }
 
+void GstVideoPlayer::SetDisplayFrameRate(int32_t frame_rate) {
+  display_frame_rate_ = frame_rate;
+  UpdateMaxFrameRate();
+}
+
+void GstVideoPlayer::UpdateMaxFrameRate() {
+  if (!gst_.video_rate) {
+    return;
+  }
+
+  // The rate is of the stream, which passes faster than the display at fast
+  // playback rates.
+  const int32_t display_frame_rate = display_frame_rate_;
+  auto max_rate = G_MAXINT;
+  if (display_frame_rate > 0) {
+    max_rate = std::max(
+        1, static_cast<int>(std::lround(display_frame_rate /
+                                        std::abs(playback_rate_.load()))));
+  }
+  g_object_set(G_OBJECT(gst_.video_rate), "max-rate", max_rate, NULL);
+}
+
+bool GstVideoPlayer::ChangeRateInstantly(double rate) {
+#if GST_CHECK_VERSION(1, 18, 0)
+  // Applies the rate to the running segment without flushing. The trick mode
+  // flags must match the ones of the segment.
+  return gst_element_seek(
+      gst_.pipeline, rate, GST_FORMAT_TIME,
+      static_cast<GstSeekFlags>(GST_SEEK_FLAG_INSTANT_RATE_CHANGE |
+                                trick_mode_flags_),
+      GST_SEEK_TYPE_NONE, 0, GST_SEEK_TYPE_NONE, 0);
+#else
+  return false;
+#endif  // GST_CHECK_VERSION(1, 18, 0)
+}
+
 bool GstVideoPlayer::SetSeek(int64_t position) {
+  if (!seek_scheduler_) {
+    return false;
+  }
+
+  // The pipeline plays again from the new position, and the pass being
+  // recorded is no longer whole.
+  StopLoopPlayback();
+  if (loop_cache_) {
+    loop_cache_->AbortRecording();
+  }
+
+  // Reports the target until a frame at the new position is rendered.
+  position_ = position;
+  {
+    std::lock_guard<std::mutex> lock(mutex_memory_level_);
+    if (memory_level_ == MemoryLevel::kSuspended) {
+      // Seeks once restored.
+      resume_position_ = position;
+      return true;
+    }
+  }
+  seek_scheduler_->Request(position);
+  return true;
+}
+
+void GstVideoPlayer::PostPlay(VideoCommandQueue::Callback callback) {
+  command_queue_->Post(
+      VideoCommandQueue::Kind::kState, [this]() { Play(); },
+      std::move(callback));
+}
+
+void GstVideoPlayer::PostPause(VideoCommandQueue::Callback callback) {
+  command_queue_->Post(
+      VideoCommandQueue::Kind::kState, [this]() { Pause(); },
+      std::move(callback));
+}
+
+void GstVideoPlayer::PostVolume(double volume,
+                                VideoCommandQueue::Callback callback) {
+  command_queue_->Post(
+      VideoCommandQueue::Kind::kVolume, [this, volume]() { SetVolume(volume); },
+      std::move(callback));
+}
+
+void GstVideoPlayer::PostPlaybackRate(double rate,
+                                      VideoCommandQueue::Callback callback) {
+  command_queue_->Post(
+      VideoCommandQueue::Kind::kPlaybackRate,
+      [this, rate]() { SetPlaybackRate(rate); }, std::move(callback));
+}
+
+void GstVideoPlayer::PostSeek(int64_t position,
+                              VideoCommandQueue::Callback callback) {
+  command_queue_->Post(
+      VideoCommandQueue::Kind::kSeek, [this, position]() { SetSeek(position); },
+      std::move(callback));
+}
+
+void GstVideoPlayer::PostAutoRepeat(bool auto_repeat,
+                                    VideoCommandQueue::Callback callback) {
+  command_queue_->Post(
+      VideoCommandQueue::Kind::kLooping,
+      [this, auto_repeat]() { SetAutoRepeat(auto_repeat); },
+      std::move(callback));
+}
+
+bool GstVideoPlayer::Seek(int64_t position, GstSeekFlags flags,
+                          guint32 seqnum) {
+  return Seek(playback_rate_, position,
+              static_cast<GstSeekFlags>(flags | trick_mode_flags_), seqnum);
+}
+
+bool GstVideoPlayer::Seek(double rate, int64_t position, GstSeekFlags flags,
+                          guint32 seqnum) {
   auto nanosecond = position * 1000 * 1000;
-  if (!gst_element_seek(
-          gst_.pipeline, playback_rate_, GST_FORMAT_TIME,
-          (GstSeekFlags)(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT),
-          GST_SEEK_TYPE_SET, nanosecond, GST_SEEK_TYPE_SET,
-          GST_CLOCK_TIME_NONE)) {
+  // Reverse playback plays the segment from its stop position.
+  const auto is_reverse = rate < 0;
+  auto* event = gst_event_new_seek(
+      rate, GST_FORMAT_TIME, flags, GST_SEEK_TYPE_SET,
+      is_reverse ? 0 : nanosecond, GST_SEEK_TYPE_SET,
+      is_reverse ? nanosecond : GST_CLOCK_TIME_NONE);
+  // The ASYNC_DONE finishing a flushing seek has the seqnum of its event.
+  gst_event_set_seqnum(event, seqnum);
+  if (!gst_element_send_event(gst_.pipeline, event)) {
     std::cerr << "Failed to seek " << nanosecond << std::endl;
     return false;
   }
@@ -141,6 +413,24 @@ int64_t GstVideoPlayer::GetDuration() {
 }
 
 int64_t GstVideoPlayer::GetCurrentPosition() {
+  const int64_t position = position_;
+  if (position < 0) {
+    // No video frame has been rendered yet, e.g. audio-only media.
+    return QueryPosition();
+  }
+
+  if (options_.validate_position) {
+    const auto queried_position = QueryPosition();
+    if (queried_position >= 0 &&
+        std::abs(queried_position - position) > kPositionValidationTolerance) {
+      std::cerr << "Position mismatch: cached = " << position
+                << ", queried = " << queried_position << std::endl;
+    }
+  }
+  return position;
+}
+
+int64_t GstVideoPlayer::QueryPosition() {
   gint64 position = 0;
 
   // Sometimes we get an error when playing streaming videos.
@@ -149,205 +439,872 @@ int64_t GstVideoPlayer::GetCurrentPosition() {
     return -1;
   }
 
-  // TODO: We need to handle this code in the proper plase.
-  // The VideoPlayer plugin doesn't have a main loop, so EOS message
-  // received from GStreamer cannot be processed directly in a callback
-  // function. This is because the event channel message of playback complettion
-  // needs to be thrown in the main thread.
-  {
-    std::unique_lock<std::mutex> lock(mutex_event_completed_);
-    if (is_completed_) {
-      is_completed_ = false;
-      lock.unlock();
-
-      stream_handler_->OnNotifyCompleted();
-      if (auto_repeat_) {
-        SetSeek(0);
-      }
-    }
-  }
-
   return position / GST_MSECOND;
 }
 
 #ifdef USE_EGL_IMAGE_DMABUF
 void* GstVideoPlayer::GetEGLImage(void* egl_display, void* egl_context) {
-  std::shared_lock<std::shared_mutex> lock(mutex_buffer_);
-  if (!gst_.buffer) {
+  // The image is in use until ReleaseFrameBuffer as in GetFrameBuffer.
+  is_frame_in_use_ = true;
+  if (is_frame_delivery_stopped_) {
+    EndFrameUse();
+    return nullptr;
+  }
+  auto* image = ImportEGLImage(egl_display, egl_context);
+  if (!image) {
+    EndFrameUse();
+  }
+  return image;
+}
+
+void* GstVideoPlayer::ImportEGLImage(void* egl_display, void* egl_context) {
+  last_visible_time_ = g_get_monotonic_time();
+  bool is_new;
+  const auto& frame = frame_exchange_.Acquire(is_new);
+  if (!frame.buffer) {
+    return nullptr;
+  }
+  if (is_new) {
+    RecordRenderedFrame(frame);
+  }
+
+  GstMemory* memory = gst_buffer_peek_memory(frame.buffer, 0);
+  if (!gst_is_dmabuf_memory(memory)) {
+    return nullptr;
+  }
+
+  if (!UpdateGLContext(egl_display, egl_context)) {
+    return nullptr;
+  }
+
+  auto* egl_image =
+      GstDmabufImageCache::Import(gst_gl_ctx_, memory, frame.info);
+  if (!egl_image) {
     return nullptr;
   }
 
-  GstMemory* memory = gst_buffer_peek_memory(gst_.buffer, 0);
-  if (gst_is_dmabuf_memory(memory)) {
+  // Keeps the image alive while it is drawn even if its memory is freed.
+  if (egl_image != gst_egl_image_) {
     UnrefEGLImage();
+    gst_egl_image_ = gst_egl_image_ref(egl_image);
+  }
+  return reinterpret_cast<void*>(gst_egl_image_get_image(gst_egl_image_));
+}
 
-    gint fd = gst_dmabuf_memory_get_fd(memory);
-    gst_gl_display_egl_ =
-        gst_gl_display_egl_new_with_egl_display(reinterpret_cast<gpointer>(egl_display));
-    gst_gl_ctx_ = gst_gl_context_new_wrapped(
-        GST_GL_DISPLAY_CAST(gst_gl_display_egl_), reinterpret_cast<guintptr>(egl_context),
-        GST_GL_PLATFORM_EGL, GST_GL_API_GLES2);
+bool GstVideoPlayer::UpdateGLContext(void* egl_display, void* egl_context) {
+  if (gst_gl_ctx_ && egl_display == egl_display_ &&
+      egl_context == egl_context_) {
+    return true;
+  }
+
+  ReleaseGLContext();
+  gst_gl_display_egl_ = gst_gl_display_egl_new_with_egl_display(
+      reinterpret_cast<gpointer>(egl_display));
+  if (!gst_gl_display_egl_) {
+    std::cerr << "Failed to wrap the EGL display" << std::endl;
+    return false;
+  }
+  gst_gl_ctx_ = gst_gl_context_new_wrapped(
+      GST_GL_DISPLAY_CAST(gst_gl_display_egl_),
+      reinterpret_cast<guintptr>(egl_context), GST_GL_PLATFORM_EGL,
+      GST_GL_API_GLES2);
+  if (!gst_gl_ctx_) {
+    std::cerr << "Failed to wrap the EGL context" << std::endl;
+    ReleaseGLContext();
+    return false;
+  }
 
-    gst_gl_context_activate(gst_gl_ctx_, TRUE);
+  // The context is always called from the raster thread.
+  gst_gl_context_activate(gst_gl_ctx_, TRUE);
+  egl_display_ = egl_display;
+  egl_context_ = egl_context;
+  return true;
+}
 
-    gst_egl_image_ =
-        gst_egl_image_from_dmabuf(gst_gl_ctx_, fd, &gst_video_info_, 0, 0);
-    return reinterpret_cast<void*>(gst_egl_image_get_image(gst_egl_image_));
+void GstVideoPlayer::ReleaseGLContext() {
+  // Cached images hold their own references to the context.
+  if (gst_gl_ctx_) {
+    gst_object_unref(gst_gl_ctx_);
+    gst_gl_ctx_ = NULL;
   }
-  return nullptr;
+  if (gst_gl_display_egl_) {
+    gst_object_unref(gst_gl_display_egl_);
+    gst_gl_display_egl_ = NULL;
+  }
+  egl_display_ = nullptr;
+  egl_context_ = nullptr;
 }
 
 void GstVideoPlayer::UnrefEGLImage() {
   if (gst_egl_image_) {
     gst_egl_image_unref(gst_egl_image_);
-    gst_object_unref(gst_gl_ctx_);
-    gst_object_unref(gst_gl_display_egl_);
     gst_egl_image_ = NULL;
-    gst_gl_ctx_ = NULL;
-    gst_gl_display_egl_ = NULL;
   }
 }
 #endif  // USE_EGL_IMAGE_DMABUF
 
-const uint8_t* GstVideoPlayer::GetFrameBuffer() {
-  std::shared_lock<std::shared_mutex> lock(mutex_buffer_);
-  if (!gst_.buffer) {
+void GstVideoPlayer::SetOutputSizeHint(int32_t width, int32_t height) {
+  if (!options_.adaptive_resolution || !gst_.caps_filter || width <= 0 ||
+      height <= 0) {
+    return;
+  }
+
+  const int32_t source_width = width_;
+  const int32_t source_height = height_;
+  if (source_width <= 0 || source_height <= 0) {
+    return;
+  }
+  if (memory_level_ == MemoryLevel::kReduced) {
+    width = std::min(width, source_width / 2);
+    height = std::min(height, source_height / 2);
+  }
+
+  // Fits the video into the requested size without upscaling it. The size is
+  // kept even for the chroma planes of YUV formats.
+  const auto scale =
+      std::min({1.0, static_cast<double>(width) / source_width,
+                static_cast<double>(height) / source_height});
+  auto target_width =
+      std::max(2, static_cast<int32_t>(source_width * scale) & ~1);
+  auto target_height =
+      std::max(2, static_cast<int32_t>(source_height * scale) & ~1);
+  if (scale == 1.0) {
+    target_width = 0;
+    target_height = 0;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_output_);
+  const auto current_width = output_width_ ? output_width_ : source_width;
+  const auto current_height = output_height_ ? output_height_ : source_height;
+  const auto requested_width = target_width ? target_width : source_width;
+  const auto requested_height = target_height ? target_height : source_height;
+  if (!IsOutsideHysteresis(current_width, requested_width) &&
+      !IsOutsideHysteresis(current_height, requested_height)) {
+    pending_output_count_ = 0;
+    return;
+  }
+
+  if (target_width != pending_output_width_ ||
+      target_height != pending_output_height_) {
+    pending_output_width_ = target_width;
+    pending_output_height_ = target_height;
+    pending_output_count_ = 0;
+  }
+  if (++pending_output_count_ < kOutputSizeStableFrames) {
+    return;
+  }
+
+  // The capsfilter asks the upstream elements to renegotiate, and videoscale
+  // starts producing frames of the new size.
+  auto* caps = CreateOutputCaps(options_, target_width, target_height);
+  g_object_set(G_OBJECT(gst_.caps_filter), "caps", caps, NULL);
+  gst_caps_unref(caps);
+  output_width_ = target_width;
+  output_height_ = target_height;
+  pending_output_count_ = 0;
+}
+
+const uint8_t* GstVideoPlayer::GetFrameBuffer(int32_t& width,
+                                              int32_t& height) {
+  // The frame is in use until ReleaseFrameBuffer, which the engine calls only
+  // if a buffer is returned. The flags are checked in the opposite order by
+  // StopFrameDelivery, so either of them sees the other.
+  is_frame_in_use_ = true;
+  if (is_frame_delivery_stopped_) {
+    EndFrameUse();
+    return nullptr;
+  }
+  const auto* pixels = CopyFrameBuffer(width, height);
+  if (!pixels) {
+    EndFrameUse();
+  }
+  return pixels;
+}
+
+void GstVideoPlayer::ReleaseFrameBuffer() {
+  UnmapFrame();
+  EndFrameUse();
+}
+
+void GstVideoPlayer::EndFrameUse() {
+  is_frame_in_use_ = false;
+  if (is_frame_delivery_stopped_) {
+    std::lock_guard<std::mutex> lock(mutex_frame_use_);
+    cv_frame_use_.notify_all();
+  }
+}
+
+void GstVideoPlayer::StopFrameDelivery() {
+  is_frame_delivery_stopped_ = true;
+  std::unique_lock<std::mutex> lock(mutex_frame_use_);
+  if (!cv_frame_use_.wait_for(lock, kFrameReleaseTimeout,
+                              [this]() { return !is_frame_in_use_; })) {
+    std::cerr << "The frame in use was not released" << std::endl;
+  }
+}
+
+const uint8_t* GstVideoPlayer::CopyFrameBuffer(int32_t& width,
+                                               int32_t& height) {
+  // The engine is expected to call ReleaseFrameBuffer after uploading the
+  // previous frame, but unmaps it here as well in case it didn't.
+  UnmapFrame();
+  last_visible_time_ = g_get_monotonic_time();
+
+  bool is_new;
+  const auto& frame = frame_exchange_.Acquire(is_new);
+  if (!frame.buffer) {
+    return nullptr;
+  }
+  if (is_new) {
+    RecordRenderedFrame(frame);
+  }
+
+  width = GST_VIDEO_INFO_WIDTH(&frame.info);
+  height = GST_VIDEO_INFO_HEIGHT(&frame.info);
+
+  // Nothing was decoded since the last copy.
+  if (!is_new && is_pixels_updated_) {
+    return reinterpret_cast<const uint8_t*>(pixels_.get());
+  }
+
+  // Maps the buffer as a video frame to respect the strides and offsets of
+  // GstVideoMeta. The mapped frame holds a reference to the buffer until it is
+  // unmapped, so the buffer stays alive even if a new one is decoded.
+  if (!gst_video_frame_map(&mapped_frame_, &frame.info, frame.buffer,
+                           GST_MAP_READ)) {
+    std::cerr << "Failed to map a video frame" << std::endl;
     return nullptr;
   }
+  is_frame_mapped_ = true;
+
+  const auto is_rgba =
+      GST_VIDEO_FRAME_FORMAT(&mapped_frame_) == GST_VIDEO_FORMAT_RGBA;
+  const auto stride = GST_VIDEO_FRAME_PLANE_STRIDE(&mapped_frame_, 0);
+  const auto* data = reinterpret_cast<const uint8_t*>(
+      GST_VIDEO_FRAME_PLANE_DATA(&mapped_frame_, 0));
+  const auto row_bytes = width * 4;
+
+  // Flutter expects tightly packed RGBA pixels.
+  if (is_rgba && options_.zero_copy && stride == row_bytes) {
+    is_pixels_updated_ = false;
+    return data;
+  }
+
+  const auto copy_start_time = g_get_monotonic_time();
+  const size_t pixel_bytes = row_bytes * height;
+  if (pixels_size_ != pixel_bytes) {
+    pixels_.reset(new uint32_t[width * height]);
+    pixels_size_ = pixel_bytes;
+  }
+  auto* pixels = reinterpret_cast<uint8_t*>(pixels_.get());
+  if (!is_rgba) {
+    // I420 or NV12 frames when Options::yuv_conversion is enabled.
+    if (!color_converter_.Convert(&mapped_frame_, pixels, row_bytes)) {
+      std::cerr << "Unsupported video format" << std::endl;
+      UnmapFrame();
+      return nullptr;
+    }
+  } else if (stride == row_bytes) {
+    std::memcpy(pixels, data, pixel_bytes);
+  } else {
+    for (int y = 0; y < height; y++) {
+      std::memcpy(pixels + y * row_bytes, data + y * stride, row_bytes);
+    }
+  }
+  UnmapFrame();
+  is_pixels_updated_ = true;
+  copied_frame_count_.fetch_add(1, std::memory_order_relaxed);
+  copy_time_.fetch_add(g_get_monotonic_time() - copy_start_time,
+                       std::memory_order_relaxed);
+
+  return pixels;
+}
+
+void GstVideoPlayer::RecordRenderedFrame(
+    const VideoFrameExchange::Frame& frame) {
+  rendered_frame_count_.fetch_add(1, std::memory_order_relaxed);
+  const auto now = g_get_monotonic_time();
+  if (options_.qos && last_consume_time_ > 0) {
+    // An exponential moving average over about 8 frames.
+    auto interval = std::min(now - last_consume_time_, kMaxConsumeInterval);
+    // The frames dropped by HandleQosBuffer stretch the interval, so it tells
+    // the pace of the texture only if the texture missed frames. Otherwise it
+    // kept up with every frame, and the average decays to let more through.
+    const auto overwritten_count = frame_exchange_.GetOverwrittenCount();
+    if (overwritten_count == last_overwritten_count_) {
+      interval /= 2;
+    }
+    last_overwritten_count_ = overwritten_count;
+    const auto average = consume_interval_.load(std::memory_order_relaxed);
+    consume_interval_.store(average ? (average * 7 + interval) / 8 : interval,
+                            std::memory_order_relaxed);
+  }
+  last_consume_time_ = now;
+
+  const auto latency = (now - frame.push_time) / 1000;
+  size_t bucket = 0;
+  while (bucket < std::size(kLatencyBucketBounds) &&
+         latency >= kLatencyBucketBounds[bucket]) {
+    bucket++;
+  }
+  latency_histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void GstVideoPlayer::SetMemoryLevel(MemoryLevel level) {
+  std::lock_guard<std::mutex> lock(mutex_memory_level_);
+  const MemoryLevel previous = memory_level_;
+  if (level == previous || !gst_.pipeline) {
+    return;
+  }
+
+  // The cached loop is released by any degradation, and recorded again once
+  // the player is back to normal.
+  if (level != MemoryLevel::kNormal && loop_cache_) {
+    const auto was_looping = StopLoopPlayback();
+    loop_cache_->Clear();
+    if (was_looping && level == MemoryLevel::kReduced) {
+      // The pipeline continues from the position of the loop.
+      seek_scheduler_->Request(position_);
+    }
+  }
+
+  if (is_network_) {
+    g_object_set(G_OBJECT(gst_.playbin), "buffer-size",
+                 level == MemoryLevel::kNormal ? -1 : kReducedNetworkBufferSize,
+                 NULL);
+  }
+
+  if (level == MemoryLevel::kSuspended) {
+    GstState state;
+    GstState pending;
+    gst_element_get_state(gst_.pipeline, &state, &pending, 0);
+    if (pending != GST_STATE_VOID_PENDING) {
+      state = pending;
+    }
+    resume_state_ = state == GST_STATE_PLAYING ? state : GST_STATE_PAUSED;
+    resume_position_ = position_.load();
+    memory_level_ = level;
+    if (gst_element_set_state(gst_.pipeline, GST_STATE_READY) ==
+        GST_STATE_CHANGE_FAILURE) {
+      std::cerr << "Failed to suspend the pipeline" << std::endl;
+    }
+    return;
+  }
+
+  memory_level_ = level;
+  if (previous == MemoryLevel::kSuspended &&
+      gst_element_set_state(gst_.pipeline, resume_state_) ==
+          GST_STATE_CHANGE_FAILURE) {
+    std::cerr << "Failed to restore the pipeline" << std::endl;
+  }
+
+  // Reduces the output right away, as the texture of a degraded player is
+  // usually not drawn and doesn't request a smaller size.
+  const int32_t source_width = width_;
+  const int32_t source_height = height_;
+  if (level != MemoryLevel::kReduced || !options_.adaptive_resolution ||
+      !gst_.caps_filter || source_width <= 0 || source_height <= 0) {
+    return;
+  }
+  const auto reduced_width = std::max(2, (source_width / 2) & ~1);
+  const auto reduced_height = std::max(2, (source_height / 2) & ~1);
+  std::lock_guard<std::mutex> output_lock(mutex_output_);
+  const auto current_width = output_width_ ? output_width_ : source_width;
+  if (current_width <= reduced_width) {
+    return;
+  }
+  auto* caps = CreateOutputCaps(options_, reduced_width, reduced_height);
+  g_object_set(G_OBJECT(gst_.caps_filter), "caps", caps, NULL);
+  gst_caps_unref(caps);
+  output_width_ = reduced_width;
+  output_height_ = reduced_height;
+}
+
+size_t GstVideoPlayer::EstimateMemoryUsage(MemoryLevel level) const {
+  const auto source_pixels = static_cast<size_t>(width_) * height_;
+  // The exchanged frames are in RGBA until the first one is decoded.
+  size_t frame_size = frame_size_;
+  if (frame_size == 0) {
+    frame_size = source_pixels * 4;
+  }
+  if (level != MemoryLevel::kNormal && options_.adaptive_resolution) {
+    // A quarter of the source in RGBA.
+    frame_size = std::min(frame_size, source_pixels);
+  }
+  auto usage = frame_size * kExchangedFrameCount + pixels_size_;
+  if (level == MemoryLevel::kNormal && loop_cache_) {
+    usage += loop_cache_->GetSize();
+  }
+  if (level == MemoryLevel::kSuspended) {
+    return usage;
+  }
+
+  // Decoders hold their frames in YUV 4:2:0.
+  usage += source_pixels * 3 / 2 * kDecoderFrameCount;
+  if (is_network_) {
+    usage += level == MemoryLevel::kNormal ? kNetworkBufferSize
+                                           : kReducedNetworkBufferSize;
+  }
+  return usage;
+}
+
+GstVideoPlayer::Stats GstVideoPlayer::GetStats() {
+  Stats stats;
+  stats.decoded_frame_count = frame_exchange_.GetPushedCount();
+  stats.rendered_frame_count = rendered_frame_count_;
+  stats.overwritten_frame_count = frame_exchange_.GetOverwrittenCount();
+  stats.qos_dropped_frame_count = qos_dropped_frame_count_;
+  stats.qos_event_count = qos_event_count_;
+  stats.throttled_frame_count = throttled_frame_count_;
+  stats.decoder_dropped_frame_count = decoder_dropped_frame_count_;
+  stats.loop_cached_frame_count = loop_cached_frame_count_;
+  if (loop_cache_) {
+    stats.loop_cache_size = loop_cache_->GetSize();
+  }
+  stats.copied_frame_count = copied_frame_count_;
+  stats.copy_time = copy_time_;
+  for (size_t i = 0; i < kLatencyBucketCount; i++) {
+    stats.latency_histogram[i] = latency_histogram_[i];
+  }
+  if (!gst_.pipeline) {
+    return stats;
+  }
+
+  // The rest is queried from the pipeline, which is fine outside the hot
+  // paths.
+  GstStructure* sink_stats = nullptr;
+  g_object_get(G_OBJECT(gst_.video_sink), "stats", &sink_stats, NULL);
+  if (sink_stats) {
+    guint64 dropped;
+    if (gst_structure_get_uint64(sink_stats, "dropped", &dropped)) {
+      stats.dropped_frame_count = dropped;
+    }
+    gst_structure_free(sink_stats);
+  }
+
+  if (gst_.video_rate) {
+    guint64 in = 0;
+    guint64 out = 0;
+    guint64 drop = 0;
+    g_object_get(G_OBJECT(gst_.video_rate), "in", &in, "out", &out, "drop",
+                 &drop, NULL);
+    stats.decimated_frame_count = drop;
+    if (out > 0) {
+      stats.decimation_ratio = static_cast<double>(in) / out;
+    }
+  }
+
+  GstTagList* tags = nullptr;
+  g_signal_emit_by_name(gst_.playbin, "get-video-tags", 0, &tags);
+  if (tags) {
+    guint bitrate;
+    if (gst_tag_list_get_uint(tags, GST_TAG_BITRATE, &bitrate) ||
+        gst_tag_list_get_uint(tags, GST_TAG_NOMINAL_BITRATE, &bitrate)) {
+      stats.bitrate = bitrate;
+    }
+    gst_tag_list_unref(tags);
+  }
+
+  auto* query = gst_query_new_buffering(GST_FORMAT_TIME);
+  if (gst_element_query(gst_.pipeline, query)) {
+    gint percent;
+    gst_query_parse_buffering_percent(query, NULL, &percent);
+    stats.buffer_percent = percent;
+  }
+  gst_query_unref(query);
 
-  const uint32_t pixel_bytes = width_ * height_ * 4;
-  gst_buffer_extract(gst_.buffer, 0, pixels_.get(), pixel_bytes);
-  return reinterpret_cast<const uint8_t*>(pixels_.get());
+  return stats;
+}
+
+void GstVideoPlayer::UnmapFrame() {
+  if (is_frame_mapped_) {
+    gst_video_frame_unmap(&mapped_frame_);
+    is_frame_mapped_ = false;
+  }
 }
 
 // Creats a video pipeline using playbin.
 // $ playbin uri=<file> video-sink="videoconvert ! video/x-raw,format=RGBA !
 // fakesink"
-bool GstVideoPlayer::CreatePipeline() {
-  gst_.pipeline = gst_pipeline_new("pipeline");
-  if (!gst_.pipeline) {
+// or, if OutputMode::kAppSink is specified:
+// $ playbin uri=<file> video-sink="videoconvert ! video/x-raw,format=RGBA !
+// appsink max-buffers=1 drop=true"
+// If Options::yuv_conversion is enabled, I420 and NV12 are also accepted by
+// the caps and converted by VideoColorConverter instead of videoconvert.
+// If Options::adaptive_resolution is enabled, the frames are scaled before
+// being converted, and the size is set to the caps by SetOutputSizeHint:
+// $ playbin uri=<file> video-sink="videoscale ! videoconvert !
+// capsfilter caps=video/x-raw,format=RGBA,width=<w>,height=<h> ! fakesink"
+// The callbacks of the pipeline are set by BindPipeline, so that the pipeline
+// can be reused by another player through GstVideoPipelinePool.
+// static
+bool GstVideoPlayer::CreatePipeline(const Options& options,
+                                    GstVideoElements& gst) {
+  gst.pipeline = gst_pipeline_new("pipeline");
+  if (!gst.pipeline) {
     std::cerr << "Failed to create a pipeline" << std::endl;
     return false;
   }
-  gst_.playbin = gst_element_factory_make("playbin", "playbin");
-  if (!gst_.playbin) {
+  gst.playbin = gst_element_factory_make("playbin", "playbin");
+  if (!gst.playbin) {
     std::cerr << "Failed to create a source" << std::endl;
     return false;
   }
-  gst_.video_convert = gst_element_factory_make("videoconvert", "videoconvert");
-  if (!gst_.video_convert) {
+  gst.video_convert = gst_element_factory_make("videoconvert", "videoconvert");
+  if (!gst.video_convert) {
     std::cerr << "Failed to create a videoconvert" << std::endl;
     return false;
   }
-  gst_.video_sink = gst_element_factory_make("fakesink", "videosink");
-  if (!gst_.video_sink) {
+  if (options.display_frame_rate > 0) {
+    gst.video_rate = gst_element_factory_make("videorate", "videorate");
+    if (!gst.video_rate) {
+      std::cerr << "Failed to create a videorate" << std::endl;
+      return false;
+    }
+  }
+  if (options.adaptive_resolution) {
+    gst.video_scale = gst_element_factory_make("videoscale", "videoscale");
+    if (!gst.video_scale) {
+      std::cerr << "Failed to create a videoscale" << std::endl;
+      return false;
+    }
+    gst.caps_filter = gst_element_factory_make("capsfilter", "capsfilter");
+    if (!gst.caps_filter) {
+      std::cerr << "Failed to create a capsfilter" << std::endl;
+      return false;
+    }
+  }
+  const auto* sink_factory =
+      options.output_mode == OutputMode::kAppSink ? "appsink" : "fakesink";
+  gst.video_sink = gst_element_factory_make(sink_factory, "videosink");
+  if (!gst.video_sink) {
     std::cerr << "Failed to create a videosink" << std::endl;
     return false;
   }
-  gst_.output = gst_bin_new("output");
-  if (!gst_.output) {
+  gst.output = gst_bin_new("output");
+  if (!gst.output) {
     std::cerr << "Failed to create an output" << std::endl;
     return false;
   }
-  gst_.bus = gst_pipeline_get_bus(GST_PIPELINE(gst_.pipeline));
-  if (!gst_.bus) {
+  gst.bus = gst_pipeline_get_bus(GST_PIPELINE(gst.pipeline));
+  if (!gst.bus) {
     std::cerr << "Failed to create a bus" << std::endl;
     return false;
   }
-  gst_bus_set_sync_handler(gst_.bus, HandleGstMessage, this, NULL);
 
-  // Sets properties to fakesink to get the callback of a decoded frame.
-  g_object_set(G_OBJECT(gst_.video_sink), "sync", TRUE, "qos", FALSE, NULL);
-  g_object_set(G_OBJECT(gst_.video_sink), "signal-handoffs", TRUE, NULL);
-  g_signal_connect(G_OBJECT(gst_.video_sink), "handoff",
-                   G_CALLBACK(HandoffHandler), this);
-  gst_bin_add_many(GST_BIN(gst_.output), gst_.video_convert, gst_.video_sink,
+  // Sets properties to the sink to get the callback of a decoded frame.
+  g_object_set(G_OBJECT(gst.video_sink), "sync", TRUE, "qos", FALSE, NULL);
+  if (options.output_mode == OutputMode::kAppSink) {
+    auto* app_sink = GST_APP_SINK(gst.video_sink);
+    gst_app_sink_set_max_buffers(app_sink, kAppSinkMaxBuffers);
+    gst_app_sink_set_drop(app_sink, TRUE);
+    gst_app_sink_set_emit_signals(app_sink, FALSE);
+  } else {
+    g_object_set(G_OBJECT(gst.video_sink), "signal-handoffs", TRUE, NULL);
+  }
+  gst_bin_add_many(GST_BIN(gst.output), gst.video_convert, gst.video_sink,
                    NULL);
 
   // Adds caps to the converter to convert the color format to RGBA.
-  auto* caps = gst_caps_from_string("video/x-raw,format=RGBA");
-  auto link_ok =
-      gst_element_link_filtered(gst_.video_convert, gst_.video_sink, caps);
+  auto* caps = CreateOutputCaps(options, 0, 0);
+  gboolean link_ok;
+  if (options.adaptive_resolution) {
+    g_object_set(G_OBJECT(gst.caps_filter), "caps", caps, NULL);
+    gst_bin_add_many(GST_BIN(gst.output), gst.video_scale, gst.caps_filter,
+                     NULL);
+    link_ok = gst_element_link_many(gst.video_scale, gst.video_convert,
+                                    gst.caps_filter, gst.video_sink, NULL);
+  } else {
+    link_ok =
+        gst_element_link_filtered(gst.video_convert, gst.video_sink, caps);
+  }
   gst_caps_unref(caps);
+
+  auto* first_element =
+      options.adaptive_resolution ? gst.video_scale : gst.video_convert;
+  if (gst.video_rate && link_ok) {
+    // Drops frames in front of the other elements, and never duplicates
+    // them.
+    g_object_set(G_OBJECT(gst.video_rate), "drop-only", TRUE, NULL);
+    gst_bin_add(GST_BIN(gst.output), gst.video_rate);
+    link_ok = gst_element_link(gst.video_rate, first_element);
+    first_element = gst.video_rate;
+  }
   if (!link_ok) {
     std::cerr << "Failed to link elements" << std::endl;
     return false;
   }
-
-  auto* sinkpad = gst_element_get_static_pad(gst_.video_convert, "sink");
+  auto* sinkpad = gst_element_get_static_pad(first_element, "sink");
   auto* ghost_sinkpad = gst_ghost_pad_new("sink", sinkpad);
   gst_pad_set_active(ghost_sinkpad, TRUE);
-  gst_element_add_pad(gst_.output, ghost_sinkpad);
+  gst_element_add_pad(gst.output, ghost_sinkpad);
 
   // Sets properties to playbin.
-  g_object_set(gst_.playbin, "uri", uri_.c_str(), NULL);
-  g_object_set(gst_.playbin, "video-sink", gst_.output, NULL);
-  gst_bin_add_many(GST_BIN(gst_.pipeline), gst_.playbin, NULL);
+  g_object_set(gst.playbin, "video-sink", gst.output, NULL);
+  gst_bin_add_many(GST_BIN(gst.pipeline), gst.playbin, NULL);
 
   return true;
 }
 
-void GstVideoPlayer::Preroll() {
-  if (!gst_.playbin) {
-    return;
+void GstVideoPlayer::BindPipeline() {
+  gst_bus_set_sync_handler(gst_.bus, HandleGstMessage, this, NULL);
+
+  // Pooled pipelines keep the maximum rate of their previous player.
+  display_frame_rate_ = options_.display_frame_rate;
+  UpdateMaxFrameRate();
+
+  // Pooled pipelines are shared by players with and without QoS.
+  g_object_set(G_OBJECT(gst_.video_sink), "qos", options_.qos, NULL);
+  if (options_.qos) {
+    // Drops frames before they reach the first element of the output.
+    auto* output_sinkpad = gst_element_get_static_pad(gst_.output, "sink");
+    qos_probe_id_ = gst_pad_add_probe(output_sinkpad, GST_PAD_PROBE_TYPE_BUFFER,
+                                      HandleQosBuffer, this, NULL);
+    gst_object_unref(output_sinkpad);
+  }
+  // Drops frames before conversion while hidden or above the target frame
+  // rate.
+  auto* output_sinkpad = gst_element_get_static_pad(gst_.output, "sink");
+  throttle_probe_id_ =
+      gst_pad_add_probe(output_sinkpad, GST_PAD_PROBE_TYPE_BUFFER,
+                        HandleThrottleBuffer, this, NULL);
+  gst_object_unref(output_sinkpad);
+
+  if (options_.output_mode == OutputMode::kAppSink) {
+    GstAppSinkCallbacks callbacks = {};
+    callbacks.new_sample = HandleNewSample;
+    gst_app_sink_set_callbacks(GST_APP_SINK(gst_.video_sink), &callbacks, this,
+                               NULL);
+  } else {
+    handoff_handler_id_ = g_signal_connect(
+        G_OBJECT(gst_.video_sink), "handoff", G_CALLBACK(HandoffHandler), this);
   }
 
-  auto result = gst_element_set_state(gst_.pipeline, GST_STATE_PAUSED);
-  if (result == GST_STATE_CHANGE_FAILURE) {
-    std::cerr << "Failed to change the state to PAUSED" << std::endl;
-    return;
+  // Tracks the segment to convert the timestamps of frames into positions.
+  auto* video_sinkpad = gst_element_get_static_pad(gst_.video_sink, "sink");
+  sink_event_probe_id_ =
+      gst_pad_add_probe(video_sinkpad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+                        HandleSinkEvent, this, NULL);
+  gst_object_unref(video_sinkpad);
+
+  if (options_.adaptive_resolution) {
+    // Tracks the size of the video before it is scaled.
+    auto* scale_sinkpad = gst_element_get_static_pad(gst_.video_scale, "sink");
+    source_caps_probe_id_ =
+        gst_pad_add_probe(scale_sinkpad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+                          HandleSourceCapsEvent, this, NULL);
+    gst_object_unref(scale_sinkpad);
   }
 
-  // Waits until the state becomes GST_STATE_PAUSED.
-  if (result == GST_STATE_CHANGE_ASYNC) {
-    GstState state;
-    result =
-        gst_element_get_state(gst_.pipeline, &state, NULL, GST_CLOCK_TIME_NONE);
-    if (result == GST_STATE_CHANGE_FAILURE) {
-      std::cerr << "Failed to get the current state" << std::endl;
-    }
+  if (!playlist_uris_.empty()) {
+    // Queues the next item before the current one ends, so that playbin
+    // prepares it without a gap.
+    about_to_finish_handler_id_ =
+        g_signal_connect(G_OBJECT(gst_.playbin), "about-to-finish",
+                         G_CALLBACK(HandleAboutToFinish), this);
   }
+
+  g_object_set(gst_.playbin, "uri", uri_.c_str(), NULL);
 }
 
-void GstVideoPlayer::DestroyPipeline() {
+void GstVideoPlayer::UnbindPipeline() {
+  if (gst_.bus) {
+    gst_bus_set_sync_handler(gst_.bus, NULL, NULL, NULL);
+  }
+
+  if (gst_.playbin && about_to_finish_handler_id_) {
+    g_signal_handler_disconnect(G_OBJECT(gst_.playbin),
+                                about_to_finish_handler_id_);
+    about_to_finish_handler_id_ = 0;
+  }
+
   if (gst_.video_sink) {
-    g_object_set(G_OBJECT(gst_.video_sink), "signal-handoffs", FALSE, NULL);
+    if (options_.output_mode == OutputMode::kAppSink) {
+      GstAppSinkCallbacks callbacks = {};
+      gst_app_sink_set_callbacks(GST_APP_SINK(gst_.video_sink), &callbacks,
+                                 NULL, NULL);
+    } else if (handoff_handler_id_) {
+      g_signal_handler_disconnect(G_OBJECT(gst_.video_sink),
+                                  handoff_handler_id_);
+    }
+    handoff_handler_id_ = 0;
+
+    if (sink_event_probe_id_) {
+      auto* video_sinkpad = gst_element_get_static_pad(gst_.video_sink, "sink");
+      gst_pad_remove_probe(video_sinkpad, sink_event_probe_id_);
+      gst_object_unref(video_sinkpad);
+      sink_event_probe_id_ = 0;
+    }
   }
 
-  if (gst_.pipeline) {
-    gst_element_set_state(gst_.pipeline, GST_STATE_NULL);
+  if (gst_.video_scale && source_caps_probe_id_) {
+    auto* scale_sinkpad = gst_element_get_static_pad(gst_.video_scale, "sink");
+    gst_pad_remove_probe(scale_sinkpad, source_caps_probe_id_);
+    gst_object_unref(scale_sinkpad);
+    source_caps_probe_id_ = 0;
   }
 
-  if (gst_.buffer) {
-    gst_buffer_unref(gst_.buffer);
-    gst_.buffer = nullptr;
+  if (gst_.output && qos_probe_id_) {
+    auto* output_sinkpad = gst_element_get_static_pad(gst_.output, "sink");
+    gst_pad_remove_probe(output_sinkpad, qos_probe_id_);
+    gst_object_unref(output_sinkpad);
+    qos_probe_id_ = 0;
   }
 
-  if (gst_.bus) {
-    gst_object_unref(gst_.bus);
-    gst_.bus = nullptr;
+  if (gst_.output && throttle_probe_id_) {
+    auto* output_sinkpad = gst_element_get_static_pad(gst_.output, "sink");
+    gst_pad_remove_probe(output_sinkpad, throttle_probe_id_);
+    gst_object_unref(output_sinkpad);
+    throttle_probe_id_ = 0;
   }
+}
 
-  if (gst_.pipeline) {
-    gst_object_unref(gst_.pipeline);
-    gst_.pipeline = nullptr;
+// static
+size_t GstVideoPlayer::PrewarmPipelines(const Options& options,
+                                        size_t count) {
+  if (!options.pipeline_pool) {
+    return 0;
   }
 
-  if (gst_.playbin) {
-    gst_.playbin = nullptr;
+  size_t added = 0;
+  for (; added < count; added++) {
+    GstVideoElements gst;
+    if (!CreatePipeline(options, gst) ||
+        gst_element_set_state(gst.pipeline, GST_STATE_READY) ==
+            GST_STATE_CHANGE_FAILURE ||
+        !options.pipeline_pool->Release(GetPipelineKey(options), gst)) {
+      GstVideoPipelinePool::Destroy(gst);
+      break;
+    }
   }
+  return added;
+}
 
-  if (gst_.output) {
-    gst_.output = nullptr;
+// static
+std::string GstVideoPlayer::GetPipelineKey(const Options& options) {
+  // Only the options which change how the pipeline is built.
+  std::string key =
+      options.output_mode == OutputMode::kAppSink ? "appsink" : "handoff";
+  if (options.yuv_conversion) {
+    key += ",yuv";
+  }
+  if (options.adaptive_resolution) {
+    key += ",scale";
   }
+  if (options.display_frame_rate > 0) {
+    key += ",rate";
+  }
+  return key;
+}
 
-  if (gst_.video_sink) {
-    gst_.video_sink = nullptr;
+void GstVideoPlayer::ResetPipeline() {
+  // Restores the properties changed by the previous player. The maximum rate
+  // and the QoS of the sink are set by BindPipeline.
+  g_object_set(gst_.playbin, "volume", volume_, "mute", mute_, NULL);
+  // Reduced by SetMemoryLevel. -1 is the default size.
+  g_object_set(G_OBJECT(gst_.playbin), "buffer-size", -1, NULL);
+  if (gst_.caps_filter) {
+    auto* caps = CreateOutputCaps(options_, 0, 0);
+    g_object_set(G_OBJECT(gst_.caps_filter), "caps", caps, NULL);
+    gst_caps_unref(caps);
+  }
+}
+
+void GstVideoPlayer::Preroll() {
+  if (!gst_.playbin) {
+    return;
+  }
+
+  // Doesn't wait for the state change, which may take a long time with
+  // network sources. OnPrerolled is called when it completes.
+  auto result = gst_element_set_state(gst_.pipeline, GST_STATE_PAUSED);
+  if (result == GST_STATE_CHANGE_FAILURE) {
+    std::cerr << "Failed to change the state to PAUSED" << std::endl;
+    stream_handler_->OnNotifyError("Failed to preroll " + uri_);
+    return;
+  }
+
+  // ASYNC_DONE isn't posted if the state changed immediately.
+  if (result != GST_STATE_CHANGE_ASYNC) {
+    OnPrerolled();
+    return;
+  }
+
+  if (options_.preroll_timeout > 0) {
+    preroll_timer_ = std::thread([this]() {
+      std::unique_lock<std::mutex> lock(mutex_preroll_);
+      if (cv_preroll_.wait_for(
+              lock, std::chrono::milliseconds(options_.preroll_timeout),
+              [this]() { return is_preroll_finished_; })) {
+        return;
+      }
+      is_preroll_finished_ = true;
+      lock.unlock();
+
+      std::cerr << "Timed out while prerolling " << uri_ << std::endl;
+      stream_handler_->OnNotifyError("Timed out while prerolling " + uri_);
+    });
+  }
+}
+
+void GstVideoPlayer::OnPrerolled() {
+  {
+    // The preroll may have already timed out.
+    std::lock_guard<std::mutex> lock(mutex_preroll_);
+    if (is_preroll_finished_) {
+      return;
+    }
+    is_preroll_finished_ = true;
+  }
+  cv_preroll_.notify_all();
+
+  if (loop_cache_) {
+    // The audio of a clip can't be looped from the cache, so clips with audio
+    // are always played by the pipeline.
+    gint audio_count = 0;
+    g_object_get(G_OBJECT(gst_.playbin), "n-audio", &audio_count, NULL);
+    is_loop_cacheable_ = playlist_uris_.empty() && audio_count == 0;
+    StartLoopRecording();
+  }
+
+  // The size is already known from the CAPS event which preceded the preroll
+  // frame.
+  is_initialized_ = true;
+  stream_handler_->OnNotifyInitialized();
+}
+
+void GstVideoPlayer::StopPrerollTimer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_preroll_);
+    is_preroll_finished_ = true;
   }
+  cv_preroll_.notify_all();
+  if (preroll_timer_.joinable()) {
+    preroll_timer_.join();
+  }
+}
 
-  if (gst_.video_convert) {
-    gst_.video_convert = nullptr;
+void GstVideoPlayer::DestroyPipeline() {
+  UnbindPipeline();
+
+  // Keeps the pipeline in the pool if possible. The READY state stops the
+  // streaming threads and releases the buffers of the current media.
+  auto* pool = options_.pipeline_pool;
+  if (pool && gst_.pipeline &&
+      gst_element_set_state(gst_.pipeline, GST_STATE_READY) !=
+          GST_STATE_CHANGE_FAILURE) {
+    // Drops the messages left for the next player.
+    gst_bus_set_flushing(gst_.bus, TRUE);
+    gst_bus_set_flushing(gst_.bus, FALSE);
+    // The texture no longer acquires frames, see StopFrameDelivery.
+    frame_exchange_.Clear();
+    if (pool->Release(GetPipelineKey(options_), gst_)) {
+      return;
+    }
   }
+
+  GstVideoPipelinePool::Destroy(gst_);
+  frame_exchange_.Clear();
 }
 
 std::string GstVideoPlayer::ParseUri(const std::string& uri) {
@@ -366,64 +1323,236 @@ std::string GstVideoPlayer::ParseUri(const std::string& uri) {
   return result_uri;
 }
 
-void GstVideoPlayer::GetVideoSize(int32_t& width, int32_t& height) {
-  if (!gst_.pipeline || !gst_.video_sink) {
-    std::cerr
-        << "Failed to get video size. The pileline hasn't initialized yet.";
-    return;
+void GstVideoPlayer::UpdateVideoSize(int32_t width, int32_t height) {
+  const auto previous_width = width_.exchange(width);
+  const auto previous_height = height_.exchange(height);
+  // The size before the initialization is sent with the initialized event.
+  if (is_initialized_ &&
+      (width != previous_width || height != previous_height)) {
+    stream_handler_->OnNotifyResized(width, height);
   }
+}
 
-  auto* sink_pad = gst_element_get_static_pad(gst_.video_sink, "sink");
-  if (!sink_pad) {
-    std::cerr << "Failed to get a pad";
-    return;
+// static
+GstCaps* GstVideoPlayer::CreateOutputCaps(const Options& options,
+                                          int32_t width, int32_t height) {
+  auto* caps = gst_caps_from_string(options.yuv_conversion ? kRgbaAndYuvCaps
+                                                           : kRgbaCaps);
+  if (width > 0 && height > 0) {
+    gst_caps_set_simple(caps, "width", G_TYPE_INT, width, "height", G_TYPE_INT,
+                        height, NULL);
+  }
+  return caps;
+}
+
+// static
+GstPadProbeReturn GstVideoPlayer::HandleSinkEvent(GstPad* pad,
+                                                  GstPadProbeInfo* info,
+                                                  gpointer user_data) {
+  auto* event = GST_PAD_PROBE_INFO_EVENT(info);
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  switch (GST_EVENT_TYPE(event)) {
+    case GST_EVENT_SEGMENT: {
+      const GstSegment* segment;
+      gst_event_parse_segment(event, &segment);
+      gst_segment_copy_into(segment, &self->segment_);
+      break;
+    }
+    case GST_EVENT_CAPS: {
+      // The format of the frames is taken from here instead of being queried
+      // for every frame, as a CAPS event always precedes the frames of a new
+      // format.
+      GstCaps* caps;
+      gst_event_parse_caps(event, &caps);
+      GstVideoInfo info;
+      if (!gst_video_info_from_caps(&info, caps)) {
+        std::cerr << "Failed to get a gst_video_info" << std::endl;
+        break;
+      }
+      self->gst_video_info_ = info;
+      self->frame_size_ = GST_VIDEO_INFO_SIZE(&info);
+      // The source size is tracked by HandleSourceCapsEvent when the output
+      // is scaled.
+      if (!self->options_.adaptive_resolution) {
+        self->UpdateVideoSize(GST_VIDEO_INFO_WIDTH(&info),
+                              GST_VIDEO_INFO_HEIGHT(&info));
+      }
+      break;
+    }
+    default:
+      break;
   }
+  return GST_PAD_PROBE_OK;
+}
 
-  auto* caps = gst_pad_get_current_caps(sink_pad);
-  auto* structure = gst_caps_get_structure(caps, 0);
-  if (!structure) {
-    std::cerr << "Failed to get a structure";
-    return;
+// static
+GstPadProbeReturn GstVideoPlayer::HandleQosBuffer(GstPad* pad,
+                                                  GstPadProbeInfo* info,
+                                                  gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  auto* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  const auto timestamp = GST_BUFFER_PTS(buffer);
+  const auto consume_interval = self->consume_interval_.load();
+  if (!GST_CLOCK_TIME_IS_VALID(timestamp) || consume_interval <= 0) {
+    return GST_PAD_PROBE_OK;
   }
 
-  gst_structure_get_int(structure, "width", &width);
-  gst_structure_get_int(structure, "height", &height);
+  // The stream time which passes between two frames consumed by the texture.
+  const auto consume_span = static_cast<GstClockTime>(
+      consume_interval * GST_USECOND * std::abs(self->playback_rate_.load()));
+  const auto duration = GST_BUFFER_DURATION_IS_VALID(buffer)
+                            ? GST_BUFFER_DURATION(buffer)
+                            : 0;
+  const auto last_timestamp = self->last_qos_timestamp_;
+  // Timestamps going back after a seek or a new item restart the count.
+  if (!GST_CLOCK_TIME_IS_VALID(last_timestamp) ||
+      timestamp <= last_timestamp ||
+      timestamp - last_timestamp + duration / 2 >= consume_span) {
+    self->last_qos_timestamp_ = timestamp;
+    return GST_PAD_PROBE_OK;
+  }
 
-#ifdef USE_EGL_IMAGE_DMABUF
-  gboolean res = gst_video_info_from_caps(&gst_video_info_, caps);
-  if (!res) {
-    std::cerr << "Failed to get a gst_video_info" << std::endl;
-    return;
+  // The frame would be overwritten before the texture consumes it, so it isn't
+  // converted. The decoder skips the frames until the next one to be shown,
+  // which it computes as |timestamp| + 2 * |diff| + |duration|.
+  self->qos_dropped_frame_count_.fetch_add(1, std::memory_order_relaxed);
+  const auto next_timestamp = last_timestamp + consume_span;
+  const auto diff = std::max<GstClockTimeDiff>(
+      0, (GST_CLOCK_DIFF(timestamp, next_timestamp) -
+          static_cast<GstClockTimeDiff>(duration)) /
+             2);
+  const auto proportion =
+      duration ? static_cast<gdouble>(consume_span) / duration : 1.0;
+  if (gst_pad_push_event(pad, gst_event_new_qos(GST_QOS_TYPE_OVERFLOW,
+                                                proportion, diff, timestamp))) {
+    self->qos_event_count_.fetch_add(1, std::memory_order_relaxed);
   }
-#endif  // USE_EGL_IMAGE_DMABUF
+  return GST_PAD_PROBE_DROP;
 }
 
 // static
-void GstVideoPlayer::HandoffHandler(GstElement* fakesink, GstBuffer* buf,
-                                    GstPad* new_pad, gpointer user_data) {
+GstPadProbeReturn GstVideoPlayer::HandleThrottleBuffer(GstPad* pad,
+                                                       GstPadProbeInfo* info,
+                                                       gpointer user_data) {
   auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
-  auto* caps = gst_pad_get_current_caps(new_pad);
-  auto* structure = gst_caps_get_structure(caps, 0);
+  auto* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  const auto timestamp = GST_BUFFER_PTS(buffer);
+  const auto duration = GST_BUFFER_DURATION(buffer);
+  const double frame_rate = self->target_frame_rate_;
+  // The frame prerolling the sink, e.g. after a seek while hidden or paused,
+  // is kept, so that the texture shows the latest position once visible.
+  if (GST_STATE(self->gst_.video_sink) != GST_STATE_PLAYING) {
+    self->last_throttle_timestamp_ = timestamp;
+    return GST_PAD_PROBE_OK;
+  }
+  if (self->is_visible_) {
+    if (frame_rate <= 0 || !GST_CLOCK_TIME_IS_VALID(timestamp)) {
+      return GST_PAD_PROBE_OK;
+    }
+
+    // The stream time which passes between two frames at the target rate.
+    const auto span = static_cast<GstClockTime>(
+        GST_SECOND / frame_rate * std::abs(self->playback_rate_.load()));
+    const auto half_duration =
+        GST_CLOCK_TIME_IS_VALID(duration) ? duration / 2 : 0;
+    const auto last_timestamp = self->last_throttle_timestamp_;
+    // Timestamps going back after a seek or a new item restart the count.
+    if (!GST_CLOCK_TIME_IS_VALID(last_timestamp) ||
+        timestamp <= last_timestamp ||
+        timestamp - last_timestamp + half_duration >= span) {
+      self->last_throttle_timestamp_ = timestamp;
+      return GST_PAD_PROBE_OK;
+    }
+  }
+
+  // The decoder keeps decoding, as the next visible frame may depend on this
+  // one, but the frame is neither converted nor notified. A gap takes its
+  // place so that the sink still prerolls and follows the clock.
+  self->throttled_frame_count_.fetch_add(1, std::memory_order_relaxed);
+  if (GST_CLOCK_TIME_IS_VALID(timestamp)) {
+    gst_pad_send_event(pad, gst_event_new_gap(timestamp, duration));
+  }
+  return GST_PAD_PROBE_DROP;
+}
+
+// static
+GstPadProbeReturn GstVideoPlayer::HandleSourceCapsEvent(GstPad* pad,
+                                                        GstPadProbeInfo* info,
+                                                        gpointer user_data) {
+  auto* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) != GST_EVENT_CAPS) {
+    return GST_PAD_PROBE_OK;
+  }
 
+  GstCaps* caps;
+  gst_event_parse_caps(event, &caps);
+  auto* structure = gst_caps_get_structure(caps, 0);
   int width;
   int height;
-  gst_structure_get_int(structure, "width", &width);
-  gst_structure_get_int(structure, "height", &height);
-  if (width != self->width_ || height != self->height_) {
-    self->width_ = width;
-    self->height_ = height;
-    self->pixels_.reset(new uint32_t[width * height]);
-    std::cout << "Pixel buffer size: width = " << width
-              << ", height = " << height << std::endl;
+  if (structure && gst_structure_get_int(structure, "width", &width) &&
+      gst_structure_get_int(structure, "height", &height)) {
+    auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+    self->UpdateVideoSize(width, height);
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+// static
+void GstVideoPlayer::HandoffHandler(GstElement* fakesink, GstBuffer* buf,
+                                    GstPad* new_pad, gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  self->PushFrame(buf);
+}
+
+// static
+GstFlowReturn GstVideoPlayer::HandleNewSample(GstAppSink* appsink,
+                                              gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  // A sample is always queued when this is called, so this doesn't block.
+  auto* sample = gst_app_sink_pull_sample(appsink);
+  if (!sample) {
+    return GST_FLOW_FLUSHING;
+  }
+
+  self->PushFrame(gst_sample_get_buffer(sample));
+  gst_sample_unref(sample);
+  return GST_FLOW_OK;
+}
+
+void GstVideoPlayer::PushFrame(GstBuffer* buffer) {
+  // The loop thread is the only producer of |frame_exchange_| while the loop
+  // is played, as the pipeline stays at its end.
+  assert(!is_loop_playing_);
+  if (is_loop_playing_) {
+    return;
+  }
+  // The sink calls this when the frame is rendered, so the frame is at the
+  // current position.
+  const auto pts = GST_BUFFER_PTS(buffer);
+  GstClockTime stream_time = GST_CLOCK_TIME_NONE;
+  if (GST_CLOCK_TIME_IS_VALID(pts)) {
+    stream_time = gst_segment_to_stream_time(&segment_, GST_FORMAT_TIME, pts);
+    if (GST_CLOCK_TIME_IS_VALID(stream_time)) {
+      position_ = static_cast<int64_t>(stream_time / GST_MSECOND);
+    }
   }
 
-  std::lock_guard<std::shared_mutex> lock(self->mutex_buffer_);
-  if (self->gst_.buffer) {
-    gst_buffer_unref(self->gst_.buffer);
-    self->gst_.buffer = nullptr;
+  frame_exchange_.Push(buffer, gst_video_info_);
+  if (loop_cache_) {
+#ifdef USE_EGL_IMAGE_DMABUF
+    // Copies of dmabufs couldn't be imported as EGLImages.
+    if (gst_is_dmabuf_memory(gst_buffer_peek_memory(buffer, 0))) {
+      is_loop_cacheable_ = false;
+      loop_cache_->AbortRecording();
+    }
+#endif  // USE_EGL_IMAGE_DMABUF
+    if (GST_CLOCK_TIME_IS_VALID(stream_time)) {
+      loop_cache_->Record(buffer, gst_video_info_, stream_time);
+    } else {
+      loop_cache_->AbortRecording();
+    }
   }
-  self->gst_.buffer = gst_buffer_ref(buf);
-  self->stream_handler_->OnNotifyFrameDecoded();
+  stream_handler_->OnNotifyFrameDecoded();
 }
 
 // static
@@ -431,10 +1560,109 @@ GstBusSyncReply GstVideoPlayer::HandleGstMessage(GstBus* bus,
                                                  GstMessage* message,
                                                  gpointer user_data) {
   switch (GST_MESSAGE_TYPE(message)) {
+    case GST_MESSAGE_ASYNC_DONE: {
+      auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+      // ASYNC_DONE is also posted after every flushing seek, but only the
+      // first one finishes the preroll.
+      if (GST_MESSAGE_SRC(message) != GST_OBJECT_CAST(self->gst_.pipeline)) {
+        break;
+      }
+      // Only the ASYNC_DONE carrying the seqnum of the seek in flight lets the
+      // scheduler issue the next seek; others, like the preroll, are ignored.
+      self->seek_scheduler_->OnAsyncDone(gst_message_get_seqnum(message));
+      if (!self->is_initialized_) {
+        self->OnPrerolled();
+      } else {
+        // A restored pipeline prerolls from the start.
+        const auto resume_position = self->resume_position_.exchange(-1);
+        if (resume_position >= 0) {
+          self->seek_scheduler_->Request(resume_position);
+        }
+      }
+      break;
+    }
     case GST_MESSAGE_EOS: {
       auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
-      std::lock_guard<std::mutex> lock(self->mutex_event_completed_);
-      self->is_completed_ = true;
+      if (self->is_loop_playing_) {
+        // Posted again when the pipeline resumes at its end while the loop
+        // is played from the cache.
+        break;
+      }
+      if (self->auto_repeat_) {
+        self->eos_loop_serial_ = self->loop_serial_.load();
+        // Seeking from the streaming thread which posted EOS could deadlock,
+        // so the pipeline restarts from the command thread, which the
+        // destructor joins.
+        std::lock_guard<std::mutex> lock(self->mutex_command_queue_);
+        if (self->command_queue_) {
+          self->command_queue_->Post(
+              VideoCommandQueue::Kind::kRestart,
+              [self]() { self->RestartPlayback(); }, nullptr);
+        }
+      } else {
+        self->stream_handler_->OnNotifyCompleted();
+      }
+      break;
+    }
+    case GST_MESSAGE_STREAM_START: {
+      auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+      // Posted when the sinks start playing the stream of an item.
+      if (GST_MESSAGE_SRC(message) != GST_OBJECT_CAST(self->gst_.pipeline) ||
+          self->playlist_uris_.empty()) {
+        break;
+      }
+      const int32_t item = self->queued_item_;
+      if (self->current_item_.exchange(item) != item) {
+        self->stream_handler_->OnNotifyPlaylistItemChanged(item);
+      }
+      break;
+    }
+    case GST_MESSAGE_BUFFERING: {
+      auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+      gint percent;
+      gst_message_parse_buffering(message, &percent);
+      const auto is_buffering = percent < 100;
+      if (self->is_buffering_.exchange(is_buffering) != is_buffering) {
+        self->stream_handler_->OnNotifyBufferingStateChanged(is_buffering);
+      }
+      break;
+    }
+    case GST_MESSAGE_STATE_CHANGED: {
+      auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+      if (GST_MESSAGE_SRC(message) != GST_OBJECT_CAST(self->gst_.pipeline)) {
+        break;
+      }
+      GstState old_state;
+      GstState new_state;
+      gst_message_parse_state_changed(message, &old_state, &new_state, NULL);
+      // The states passed through while suspending the pipeline or restoring
+      // it are not reported.
+      if (self->memory_level_ == MemoryLevel::kSuspended ||
+          (GST_STATE_TARGET(self->gst_.pipeline) == GST_STATE_PLAYING &&
+           new_state != GST_STATE_PLAYING)) {
+        break;
+      }
+      const auto is_playing = new_state == GST_STATE_PLAYING;
+      if (self->is_playing_.exchange(is_playing) != is_playing) {
+        self->stream_handler_->OnNotifyPlayingStateChanged(is_playing);
+      }
+      break;
+    }
+    case GST_MESSAGE_QOS: {
+      auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+      // The sink's drops are counted by its own statistics, and the
+      // converters of the output bin post QoS messages as well.
+      if (!GST_IS_VIDEO_DECODER(GST_MESSAGE_SRC(message))) {
+        break;
+      }
+      GstFormat format;
+      guint64 processed;
+      guint64 dropped;
+      gst_message_parse_qos_stats(message, &format, &processed, &dropped);
+      if (format == GST_FORMAT_BUFFERS) {
+        // The count is cumulative for each element.
+        self->decoder_dropped_frame_count_ = dropped;
+      }
       break;
     }
     case GST_MESSAGE_WARNING: {
@@ -455,6 +1683,9 @@ GstBusSyncReply GstVideoPlayer::HandleGstMessage(GstBus* bus,
       g_printerr("ERROR from element %s: %s\n", GST_OBJECT_NAME(message->src),
                  error->message);
       g_printerr("Error details: %s\n", debug);
+      auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+      self->stream_handler_->OnNotifyError(
+          std::string(GST_OBJECT_NAME(message->src)) + ": " + error->message);
       g_free(debug);
       g_error_free(error);
       break;
@@ -464,3 +1695,175 @@ GstBusSyncReply GstVideoPlayer::HandleGstMessage(GstBus* bus,
   }
   return GST_BUS_PASS;
 }
+
+// static
+void GstVideoPlayer::HandleAboutToFinish(GstElement* playbin,
+                                         gpointer user_data) {
+  auto* self = reinterpret_cast<GstVideoPlayer*>(user_data);
+  // Counts from the current item, as this is emitted again for the same item
+  // if it is seeked after the next item was queued.
+  auto next_item = self->current_item_ + 1;
+  if (next_item >= static_cast<int32_t>(self->playlist_uris_.size())) {
+    if (!self->auto_repeat_) {
+      // Ends with EOS.
+      return;
+    }
+    next_item = 0;
+  }
+
+  self->queued_item_ = next_item;
+  g_object_set(G_OBJECT(playbin), "uri",
+               self->playlist_uris_[next_item].c_str(), NULL);
+}
+
+void GstVideoPlayer::RestartPlayback() {
+  if (!playlist_uris_.empty() && current_item_ != 0) {
+    // Looping was enabled too late to queue the first item to playbin, so the
+    // playlist is restarted from the first item.
+    gst_element_set_state(gst_.pipeline, GST_STATE_READY);
+    queued_item_ = 0;
+    position_ = 0;
+    g_object_set(G_OBJECT(gst_.playbin), "uri",
+                 playlist_uris_[0].c_str(), NULL);
+    gst_element_set_state(gst_.pipeline, GST_STATE_PLAYING);
+    return;
+  }
+  if (playback_rate_ > 0 && FinishLoopRecording() &&
+      StartLoopPlayback(eos_loop_serial_)) {
+    return;
+  }
+  if (playback_rate_ < 0) {
+    // Reverse playback restarts from the end.
+    const auto duration = GetDuration();
+    if (duration < 0) {
+      stream_handler_->OnNotifyCompleted();
+      return;
+    }
+    SetSeek(duration);
+    return;
+  }
+  SetSeek(0);
+  // The pass played from the start is recorded.
+  StartLoopRecording();
+}
+
+void GstVideoPlayer::StartLoopRecording() {
+  if (!loop_cache_ || !is_loop_cacheable_ ||
+      memory_level_ != MemoryLevel::kNormal) {
+    return;
+  }
+  loop_record_drop_count_ = throttled_frame_count_ + qos_dropped_frame_count_;
+  loop_cache_->StartRecording();
+}
+
+bool GstVideoPlayer::FinishLoopRecording() {
+  if (!loop_cache_) {
+    return false;
+  }
+  if (throttled_frame_count_ + qos_dropped_frame_count_ !=
+      loop_record_drop_count_) {
+    // Some frames of the pass were dropped before being recorded.
+    loop_cache_->AbortRecording();
+  }
+  return loop_cache_->FinishRecording();
+}
+
+bool GstVideoPlayer::StartLoopPlayback(uint64_t serial) {
+  std::lock_guard<std::mutex> lock(mutex_loop_thread_);
+  if (serial != loop_serial_) {
+    return false;
+  }
+  if (is_loop_playing_) {
+    return true;
+  }
+  // The thread of a loop which completed.
+  if (loop_thread_.joinable()) {
+    loop_thread_.join();
+  }
+  {
+    std::lock_guard<std::mutex> loop_lock(mutex_loop_);
+    is_loop_stopped_ = false;
+  }
+  is_loop_playing_ = true;
+  loop_thread_ = std::thread(&GstVideoPlayer::RunLoopPlayback, this);
+  return true;
+}
+
+bool GstVideoPlayer::StopLoopPlayback() {
+  std::lock_guard<std::mutex> lock(mutex_loop_thread_);
+  loop_serial_++;
+  if (!loop_thread_.joinable()) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> loop_lock(mutex_loop_);
+    is_loop_stopped_ = true;
+  }
+  cv_loop_.notify_all();
+  loop_thread_.join();
+  return is_loop_playing_.exchange(false);
+}
+
+void GstVideoPlayer::SetLoopPaused(bool is_paused) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_loop_);
+    is_loop_paused_ = is_paused;
+  }
+  cv_loop_.notify_all();
+}
+
+void GstVideoPlayer::RunLoopPlayback() {
+  // The frames stay valid until the cache is cleared, which is done only
+  // after this thread is stopped.
+  const auto& frames = loop_cache_->GetFrames();
+  size_t index = 0;
+  auto deadline = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mutex_loop_);
+  while (true) {
+    if (is_loop_paused_) {
+      cv_loop_.wait(lock,
+                    [this]() { return is_loop_stopped_ || !is_loop_paused_; });
+      deadline = std::chrono::steady_clock::now();
+    }
+    if (is_loop_stopped_) {
+      return;
+    }
+    lock.unlock();
+
+    // Pushed as the sink would, but only by reference.
+    const auto& frame = frames[index];
+    position_ = static_cast<int64_t>(frame.timestamp / GST_MSECOND);
+    if (is_visible_) {
+      frame_exchange_.Push(frame.buffer, frame.info);
+      stream_handler_->OnNotifyFrameDecoded();
+    }
+    loop_cached_frame_count_.fetch_add(1, std::memory_order_relaxed);
+
+    GstClockTime interval = frame.duration;
+    if (++index < frames.size()) {
+      const auto next_timestamp = frames[index].timestamp;
+      interval = next_timestamp > frame.timestamp
+                     ? next_timestamp - frame.timestamp
+                     : 0;
+    } else {
+      index = 0;
+      if (!auto_repeat_) {
+        // Stays on the last frame like the pipeline at its end.
+        is_loop_playing_ = false;
+        stream_handler_->OnNotifyCompleted();
+        return;
+      }
+    }
+
+    // The rate is positive while the loop is played, as reversing it seeks
+    // the pipeline.
+    deadline += std::chrono::nanoseconds(
+        static_cast<int64_t>(interval / playback_rate_.load()));
+    // Frames late for their time are shown right away rather than in a burst.
+    deadline = std::max(deadline, std::chrono::steady_clock::now());
+    lock.lock();
+    cv_loop_.wait_until(lock, deadline, [this]() {
+      return is_loop_stopped_ || is_loop_paused_;
+    });
+  }
+}
@@ -5,90 +5,444 @@
 #ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_PLAYER_H_
 #define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_PLAYER_H_
 
+#include <gst/app/gstappsink.h>
 #include <gst/gst.h>
+#include <gst/video/video.h>
 
 #ifdef USE_EGL_IMAGE_DMABUF
 #include <gst/allocators/gstdmabuf.h>
 #include <gst/gl/egl/egl.h>
 #include <gst/gl/gl.h>
-#include <gst/video/video.h>
 #endif  // USE_EGL_IMAGE_DMABUF
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "gst_seek_scheduler.h"
+#include "gst_video_pipeline_pool.h"
+#include "video_color_converter.h"
+#include "video_command_queue.h"
+#include "video_frame_exchange.h"
+#include "video_loop_cache.h"
 #include "video_player_stream_handler.h"
 
+class GstVideoMemoryBudget;
+
 class GstVideoPlayer {
  public:
+  enum class OutputMode {
+    // Receives decoded frames through the handoff signal of fakesink.
+    kHandoff,
+    // Receives decoded frames through the callbacks of a bounded appsink.
+    kAppSink,
+  };
+
+  // How much the player is degraded to fit the memory budget.
+  enum class MemoryLevel {
+    kNormal,
+    // Halves the output size with Options::adaptive_resolution, and shrinks
+    // the buffers of network streams.
+    kReduced,
+    // Stops decoding by setting the pipeline to READY, which releases the
+    // decoder and its queues. The last frame is still drawn, and the playback
+    // resumes from the same position once restored.
+    kSuspended,
+  };
+
+  struct Options {
+    // Hands the mapped decoded frame to the engine instead of copying it into
+    // an intermediate buffer. A copy is still made when the stride of the
+    // frame doesn't match its width.
+    bool zero_copy = true;
+    OutputMode output_mode = OutputMode::kHandoff;
+    // Accepts I420 and NV12 frames from the decoder and converts them to RGBA
+    // with the SIMD kernels of VideoColorConverter instead of videoconvert.
+    bool yuv_conversion = false;
+    // Scales decoded frames down to the size the texture is drawn at, so that
+    // conversion and copies don't run at the full source resolution.
+    bool adaptive_resolution = false;
+    // Reports an error if the pipeline isn't prerolled within this time in
+    // milliseconds. Zero disables the timeout.
+    int64_t preroll_timeout = 30000;
+    // Also queries the position from the pipeline, and logs it if it differs
+    // from the position derived from the rendered frames.
+    bool validate_position = false;
+    // Reuses an idle pipeline of the pool if any, and returns the pipeline to
+    // the pool when the player is destroyed. Not owned.
+    GstVideoPipelinePool* pipeline_pool = nullptr;
+    // The uris played after the uri of the player without gaps. The uri of
+    // the player is the item 0 of the playlist.
+    std::vector<std::string> playlist;
+    // Seeks to the exact requested position instead of a keyframe. Seeks
+    // requested while scrubbing still snap to the nearest keyframe, and the
+    // exact position is sought once the scrub settles.
+    bool accurate_seek = false;
+    // Drops frames which the texture can't consume in time before they are
+    // converted, and asks the decoder to skip them with QoS events. The sink
+    // also drops frames which are late for the clock.
+    bool qos = false;
+    // Registers the player to the budget, which degrades it when the players
+    // use more memory than allowed. Not owned.
+    GstVideoMemoryBudget* memory_budget = nullptr;
+    // The refresh rate of the display in frames per second. When positive,
+    // the frames which the display can't show are dropped by videorate before
+    // they are converted.
+    int32_t display_frame_rate = 0;
+    // The limit in bytes of the frames cached from the first pass of a
+    // looping clip. When positive, a clip without audio whose output frames
+    // fit in it is looped from memory once it has been played through, until
+    // it is sought, reversed or degraded by the memory budget. Zero disables
+    // the cache.
+    size_t loop_cache_size = 0;
+  };
+
+  // The upper bounds in milliseconds of the buckets of
+  // Stats::latency_histogram. The last bucket has no upper bound.
+  static constexpr int64_t kLatencyBucketBounds[] = {4, 8, 16, 33, 66, 133};
+  static constexpr size_t kLatencyBucketCount =
+      std::size(kLatencyBucketBounds) + 1;
+
+  struct Stats {
+    // Frames decoded, and frames consumed by GetFrameBuffer or GetEGLImage.
+    uint64_t decoded_frame_count = 0;
+    uint64_t rendered_frame_count = 0;
+    // Frames dropped by the sink for being late, and frames replaced by newer
+    // ones before being consumed.
+    uint64_t dropped_frame_count = 0;
+    uint64_t overwritten_frame_count = 0;
+    // Frames dropped before conversion with Options::qos, the QoS events sent
+    // upstream for them, and the frames the decoder reported as skipped.
+    uint64_t qos_dropped_frame_count = 0;
+    uint64_t qos_event_count = 0;
+    uint64_t decoder_dropped_frame_count = 0;
+    // Frames dropped before conversion while hidden or above the target frame
+    // rate.
+    uint64_t throttled_frame_count = 0;
+    // Frames dropped to the display rate with Options::display_frame_rate,
+    // and the number of decoded frames per frame passed on.
+    uint64_t decimated_frame_count = 0;
+    double decimation_ratio = 1.0;
+    // Frames played from the cache with Options::loop_cache_size, and the
+    // size in bytes of the cached frames.
+    uint64_t loop_cached_frame_count = 0;
+    size_t loop_cache_size = 0;
+    // Frames copied or converted by GetFrameBuffer, and the total time spent
+    // on them in microseconds.
+    uint64_t copied_frame_count = 0;
+    uint64_t copy_time = 0;
+    // The number of consumed frames by their latency from being decoded.
+    std::array<uint64_t, kLatencyBucketCount> latency_histogram = {};
+    // The bitrate of the video stream in bits per second, or -1 if unknown.
+    int64_t bitrate = -1;
+    // The fill level of the buffers of network streams in percent, or -1 if
+    // unknown.
+    int32_t buffer_percent = -1;
+  };
+
+  // Starts prerolling the pipeline without waiting for it.
+  // VideoPlayerStreamHandler::OnNotifyInitialized is called once it's done.
   GstVideoPlayer(const std::string& uri,
-                 std::unique_ptr<VideoPlayerStreamHandler> handler);
+                 std::unique_ptr<VideoPlayerStreamHandler> handler,
+                 const Options& options);
   ~GstVideoPlayer();
 
   static void GstLibraryLoad();
   static void GstLibraryUnload();
 
+  // Creates up to |count| idle pipelines for |options| in
+  // Options::pipeline_pool ahead of the players using them. Returns the
+  // number of pipelines added to the pool.
+  static size_t PrewarmPipelines(const Options& options, size_t count);
+
   bool Play();
   bool Pause();
   bool Stop();
   bool SetVolume(double volume);
   bool SetPlaybackRate(double rate);
   void SetAutoRepeat(bool auto_repeat) { auto_repeat_ = auto_repeat; };
+  // A hidden player drops its decoded frames before they are converted, while
+  // its audio and clock keep running, and shows the next decoded frame once
+  // visible again.
+  void SetVisible(bool is_visible) { is_visible_ = is_visible; }
+  // Drops the decoded frames exceeding |fps| before they are converted. Zero
+  // means unlimited.
+  void SetTargetFrameRate(double fps) { target_frame_rate_ = fps; }
+  // Changes the refresh rate of the display. This has no effect unless the
+  // player was created with Options::display_frame_rate.
+  void SetDisplayFrameRate(int32_t frame_rate);
+  // Schedules a seek without waiting for it. Seeks requested while another
+  // one is in flight are coalesced into the latest one.
   bool SetSeek(int64_t position);
+  // Post the commands above to the command queue of the player, and call
+  // |callback| on its worker thread once they have run, or have been replaced
+  // by a later command of the same kind.
+  void PostPlay(VideoCommandQueue::Callback callback);
+  void PostPause(VideoCommandQueue::Callback callback);
+  void PostVolume(double volume, VideoCommandQueue::Callback callback);
+  void PostPlaybackRate(double rate, VideoCommandQueue::Callback callback);
+  void PostSeek(int64_t position, VideoCommandQueue::Callback callback);
+  void PostAutoRepeat(bool auto_repeat, VideoCommandQueue::Callback callback);
+  bool IsInitialized() const { return is_initialized_; }
   int64_t GetDuration();
+  // Returns the position of the last rendered frame without querying the
+  // pipeline. The pipeline is queried only until a frame is rendered.
   int64_t GetCurrentPosition();
-  const uint8_t* GetFrameBuffer();
+  // Requests decoded frames of at most |width| x |height| when
+  // Options::adaptive_resolution is enabled. The aspect ratio of the video is
+  // kept, and the output is renegotiated only after the requested size has
+  // changed noticeably for a while. This must be called from the same thread
+  // as GetFrameBuffer.
+  void SetOutputSizeHint(int32_t width, int32_t height);
+  // Returns the latest decoded frame in RGBA and sets its size to |width| and
+  // |height|.
+  const uint8_t* GetFrameBuffer(int32_t& width, int32_t& height);
+  // Releases the frame returned by the last GetFrameBuffer or GetEGLImage
+  // call. This must be called from the same thread as them, and the player
+  // waits for it before being destroyed.
+  void ReleaseFrameBuffer();
 #ifdef USE_EGL_IMAGE_DMABUF
+  // Returns the latest decoded frame imported as an EGLImage, which is kept
+  // alive until ReleaseFrameBuffer.
   void* GetEGLImage(void* egl_display, void* egl_context);
 #endif  // USE_EGL_IMAGE_DMABUF
   int32_t GetWidth() const { return width_; };
   int32_t GetHeight() const { return height_; };
+  // Returns the number of decoded frames which were replaced by newer ones
+  // before being consumed by GetFrameBuffer.
+  uint64_t GetOverwrittenFrameCount() const {
+    return frame_exchange_.GetOverwrittenCount();
+  }
+  // Returns the number of frames consumed by GetFrameBuffer or GetEGLImage.
+  uint64_t GetRenderedFrameCount() const { return rendered_frame_count_; }
+  Stats GetStats();
+  void SetMemoryLevel(MemoryLevel level);
+  MemoryLevel GetMemoryLevel() const { return memory_level_; }
+  // Returns the estimated memory in bytes held by the decoded frames of the
+  // player and by its decoder and queues.
+  size_t GetMemoryUsage() const { return EstimateMemoryUsage(memory_level_); }
+  size_t EstimateMemoryUsage(MemoryLevel level) const;
+  // Returns the monotonic time in microseconds when the texture last fetched
+  // a frame, which is the creation time until it does.
+  int64_t GetLastVisibleTime() const { return last_visible_time_; }
 
  private:
-  struct GstVideoElements {
-    GstElement* pipeline;
-    GstElement* playbin;
-    GstElement* video_convert;
-    GstElement* video_sink;
-    GstElement* output;
-    GstBus* bus;
-    GstBuffer* buffer;
-  };
-
   static void HandoffHandler(GstElement* fakesink, GstBuffer* buf,
                              GstPad* new_pad, gpointer user_data);
+  static GstFlowReturn HandleNewSample(GstAppSink* appsink,
+                                       gpointer user_data);
+  static GstPadProbeReturn HandleSinkEvent(GstPad* pad, GstPadProbeInfo* info,
+                                           gpointer user_data);
+  static GstPadProbeReturn HandleSourceCapsEvent(GstPad* pad,
+                                                 GstPadProbeInfo* info,
+                                                 gpointer user_data);
+  static GstPadProbeReturn HandleQosBuffer(GstPad* pad, GstPadProbeInfo* info,
+                                           gpointer user_data);
+  static GstPadProbeReturn HandleThrottleBuffer(GstPad* pad,
+                                                GstPadProbeInfo* info,
+                                                gpointer user_data);
   static GstBusSyncReply HandleGstMessage(GstBus* bus, GstMessage* message,
                                           gpointer user_data);
+  static void HandleAboutToFinish(GstElement* playbin, gpointer user_data);
   std::string ParseUri(const std::string& uri);
-  bool CreatePipeline();
+  static bool CreatePipeline(const Options& options, GstVideoElements& gst);
+  static std::string GetPipelineKey(const Options& options);
+  static GstCaps* CreateOutputCaps(const Options& options, int32_t width,
+                                   int32_t height);
+  void BindPipeline();
+  void UnbindPipeline();
+  void ResetPipeline();
   void DestroyPipeline();
   void Preroll();
-  void GetVideoSize(int32_t& width, int32_t& height);
+  void OnPrerolled();
+  void StopPrerollTimer();
+  // Updates the size of the video, and notifies it if it changed after the
+  // initialization.
+  void UpdateVideoSize(int32_t width, int32_t height);
+  void PushFrame(GstBuffer* buffer);
+  int64_t QueryPosition();
+  // Seeks by a seek event whose sequence number is |seqnum|.
+  bool Seek(int64_t position, GstSeekFlags flags, guint32 seqnum);
+  bool Seek(double rate, int64_t position, GstSeekFlags flags, guint32 seqnum);
+  bool ChangeRateInstantly(double rate);
+  // Limits the frame rate of the stream so that the display rate isn't
+  // exceeded at the current playback rate.
+  void UpdateMaxFrameRate();
+  // Records the next pass of the clip to the loop cache if it can be cached.
+  void StartLoopRecording();
+  // Ends the recording at the end of the clip. Returns true if the whole clip
+  // is cached.
+  bool FinishLoopRecording();
+  // Plays the cached loop in place of the pipeline, which stays at its end,
+  // unless StopLoopPlayback was called since the loop serial was |serial|.
+  // Returns true if the loop is played. The loop thread then pushes to
+  // |frame_exchange_| in place of the sink, which must not push until
+  // StopLoopPlayback returns.
+  bool StartLoopPlayback(uint64_t serial);
+  // Stops playing the cached loop before the pipeline is used again. Returns
+  // true if it was being played.
+  bool StopLoopPlayback();
+  void SetLoopPaused(bool is_paused);
+  void RunLoopPlayback();
+  // Restarts a looping playback at its end.
+  void RestartPlayback();
+  const uint8_t* CopyFrameBuffer(int32_t& width, int32_t& height);
+  void EndFrameUse();
+  // Stops handing frames to the texture, and waits for the one in use.
+  void StopFrameDelivery();
+  void UnmapFrame();
+  void RecordRenderedFrame(const VideoFrameExchange::Frame& frame);
 #ifdef USE_EGL_IMAGE_DMABUF
+  void* ImportEGLImage(void* egl_display, void* egl_context);
+  bool UpdateGLContext(void* egl_display, void* egl_context);
+  void ReleaseGLContext();
   void UnrefEGLImage();
 #endif  // USE_EGL_IMAGE_DMABUF
 
   GstVideoElements gst_;
+  gulong handoff_handler_id_ = 0;
+  gulong about_to_finish_handler_id_ = 0;
+  gulong sink_event_probe_id_ = 0;
+  gulong source_caps_probe_id_ = 0;
+  gulong qos_probe_id_ = 0;
+  gulong throttle_probe_id_ = 0;
+  Options options_;
   std::string uri_;
-  std::unique_ptr<uint32_t> pixels_;
-  int32_t width_;
-  int32_t height_;
+  // The uri of the player followed by Options::playlist.
+  std::vector<std::string> playlist_uris_;
+  // The item being played, and the item queued to playbin to be played next.
+  std::atomic<int32_t> current_item_ = 0;
+  std::atomic<int32_t> queued_item_ = 0;
+  std::unique_ptr<uint32_t[]> pixels_;
+  // Read by EstimateMemoryUsage.
+  std::atomic<size_t> pixels_size_ = 0;
+  // The size in bytes of the last decoded frame.
+  std::atomic<size_t> frame_size_ = 0;
+  // The size of the decoded video before it is scaled.
+  std::atomic<int32_t> width_ = 0;
+  std::atomic<int32_t> height_ = 0;
+  // The format of the output, updated from the CAPS events which precede the
+  // frames. Accessed only from the streaming thread once the pipeline is
+  // running.
+  GstVideoInfo gst_video_info_;
+  GstSegment segment_;
+  // The position in milliseconds, or -1 until a frame is rendered.
+  std::atomic<int64_t> position_ = -1;
+  VideoFrameExchange frame_exchange_;
+  // Accessed only from the raster thread.
+  GstVideoFrame mapped_frame_;
+  bool is_frame_mapped_ = false;
+  // Whether the raster thread holds a frame which isn't released yet, and
+  // whether frames are no longer handed out, as the player is being destroyed.
+  std::atomic<bool> is_frame_in_use_ = false;
+  std::atomic<bool> is_frame_delivery_stopped_ = false;
+  std::mutex mutex_frame_use_;
+  std::condition_variable cv_frame_use_;
+  VideoColorConverter color_converter_;
+  bool is_pixels_updated_ = false;
+  // Sampled on the raster thread and read by GetStats.
+  std::atomic<uint64_t> rendered_frame_count_ = 0;
+  std::atomic<uint64_t> copied_frame_count_ = 0;
+  std::atomic<uint64_t> copy_time_ = 0;
+  std::array<std::atomic<uint64_t>, kLatencyBucketCount> latency_histogram_ =
+      {};
+  // The average interval in microseconds between frames consumed by the
+  // texture, fed back to the streaming thread with Options::qos.
+  std::atomic<int64_t> consume_interval_ = 0;
+  gint64 last_consume_time_ = 0;
+  uint64_t last_overwritten_count_ = 0;
+  // The timestamp of the last frame passed to the converter. Accessed only
+  // from the streaming thread.
+  GstClockTime last_qos_timestamp_ = GST_CLOCK_TIME_NONE;
+  std::atomic<uint64_t> qos_dropped_frame_count_ = 0;
+  std::atomic<uint64_t> qos_event_count_ = 0;
+  std::atomic<uint64_t> decoder_dropped_frame_count_ = 0;
+  std::atomic<bool> is_visible_ = true;
+  std::atomic<double> target_frame_rate_ = 0;
+  // The timestamp of the last frame passed at the target frame rate. Accessed
+  // only from the streaming thread.
+  GstClockTime last_throttle_timestamp_ = GST_CLOCK_TIME_NONE;
+  std::atomic<uint64_t> throttled_frame_count_ = 0;
+  std::atomic<int32_t> display_frame_rate_ = 0;
+  // Created with Options::loop_cache_size.
+  std::unique_ptr<VideoLoopCache> loop_cache_;
+  // Whether the clip can be looped from the cache, which is known once the
+  // pipeline is prerolled.
+  std::atomic<bool> is_loop_cacheable_ = false;
+  // The frames dropped before the recording started, as a recording missing
+  // frames isn't used.
+  std::atomic<uint64_t> loop_record_drop_count_ = 0;
+  // Incremented by StopLoopPlayback, so that a loop isn't started by an EOS
+  // which a seek has overtaken. Changed with |mutex_loop_thread_| held.
+  std::atomic<uint64_t> loop_serial_ = 0;
+  // The serial when the last EOS was posted.
+  std::atomic<uint64_t> eos_loop_serial_ = 0;
+  std::thread loop_thread_;
+  std::mutex mutex_loop_thread_;
+  // Guards the flags below, which are waited for by the loop thread.
+  std::mutex mutex_loop_;
+  std::condition_variable cv_loop_;
+  bool is_loop_stopped_ = false;
+  bool is_loop_paused_ = true;
+  std::atomic<bool> is_loop_playing_ = false;
+  std::atomic<uint64_t> loop_cached_frame_count_ = 0;
+  // The size requested from the output caps. Zero means the source size.
+  // Guarded by |mutex_output_|, as the memory budget also reduces it.
+  int32_t output_width_ = 0;
+  int32_t output_height_ = 0;
+  std::mutex mutex_output_;
+  // The size waiting to be stable before it is requested.
+  int32_t pending_output_width_ = 0;
+  int32_t pending_output_height_ = 0;
+  int pending_output_count_ = 0;
   double volume_ = 1.0;
-  double playback_rate_ = 1.0;
+  // Read by the seek scheduler.
+  std::atomic<double> playback_rate_ = 1.0;
+  // The trick mode flags of the current rate, added to every seek.
+  std::atomic<int> trick_mode_flags_ = 0;
   bool mute_ = false;
-  bool auto_repeat_ = false;
-  bool is_completed_ = false;
-  std::mutex mutex_event_completed_;
-  std::shared_mutex mutex_buffer_;
+  std::atomic<bool> auto_repeat_ = false;
+  // Bus messages are handled on the threads which posted them.
+  std::atomic<bool> is_buffering_ = false;
+  std::atomic<bool> is_playing_ = false;
+  std::atomic<bool> is_initialized_ = false;
+  // Waits for the preroll until Options::preroll_timeout.
+  std::thread preroll_timer_;
+  std::mutex mutex_preroll_;
+  std::condition_variable cv_preroll_;
+  bool is_preroll_finished_ = false;
+  std::unique_ptr<GstSeekScheduler> seek_scheduler_;
+  // Destroyed first, as its commands use the pipeline.
+  std::unique_ptr<VideoCommandQueue> command_queue_ =
+      std::make_unique<VideoCommandQueue>();
+  // Guards |command_queue_| against the bus handler while it is destroyed.
+  std::mutex mutex_command_queue_;
   std::unique_ptr<VideoPlayerStreamHandler> stream_handler_;
+  bool is_network_ = false;
+  std::atomic<MemoryLevel> memory_level_ = MemoryLevel::kNormal;
+  std::atomic<int64_t> last_visible_time_ = 0;
+  // Guards the state changes made by Play, Pause and SetMemoryLevel.
+  std::mutex mutex_memory_level_;
+  // The state to restore a suspended pipeline to.
+  GstState resume_state_ = GST_STATE_PAUSED;
+  // The position to seek to once a suspended pipeline is prerolled, or -1.
+  std::atomic<int64_t> resume_position_ = -1;
 
 #ifdef USE_EGL_IMAGE_DMABUF
-  GstVideoInfo gst_video_info_;
+  // The image being drawn by the engine. Imported images are cached on the
+  // GstMemory of each dmabuf, so this only keeps the current one alive.
   GstEGLImage* gst_egl_image_ = NULL;
+  // Wrappers of the EGL display and context of the engine, which are created
+  // once and reused while the engine passes the same ones.
   GstGLContext* gst_gl_ctx_ = NULL;
   GstGLDisplayEGL* gst_gl_display_egl_ = NULL;
+  void* egl_display_ = nullptr;
+  void* egl_context_ = nullptr;
 #endif  // USE_EGL_IMAGE_DMABUF
 };
 
@@ -0,0 +1,307 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gst_video_wall_player.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+class GstVideoWallPlayer::TileStreamHandler : public VideoPlayerStreamHandler {
+ public:
+  TileStreamHandler(GstVideoWallPlayer* wall, size_t index)
+      : wall_(wall), index_(index) {}
+  ~TileStreamHandler() = default;
+
+ protected:
+  // |VideoPlayerStreamHandler|
+  void OnNotifyInitializedInternal() { wall_->OnTileInitialized(); }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyFrameDecodedInternal() { wall_->OnTileFrameDecoded(); }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyCompletedInternal() { wall_->OnTileCompleted(); }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyBufferingStateChangedInternal(bool is_buffering) {
+    wall_->OnTileBufferingStateChanged(is_buffering);
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlayingStateChangedInternal(bool is_playing) {
+    wall_->OnTilePlayingStateChanged(is_playing);
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlaylistItemChangedInternal(int32_t index) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlaybackRateChangedInternal(double rate,
+                                           const std::string& mode) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyResizedInternal(int32_t width, int32_t height) {}
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyErrorInternal(const std::string& message) {
+    wall_->OnTileError(index_, message);
+  }
+
+ private:
+  GstVideoWallPlayer* wall_;
+  const size_t index_;
+};
+
+GstVideoWallPlayer::GstVideoWallPlayer(
+    const std::vector<std::string>& uris,
+    std::unique_ptr<VideoPlayerStreamHandler> handler, const Options& options)
+    : width_(std::max(options.width, 1)),
+      height_(std::max(options.height, 1)),
+      stream_handler_(std::move(handler)) {
+  pixels_.reset(new uint8_t[width_ * height_ * 4]);
+  FillRect({0, 0, width_, height_});
+
+  auto layout = options.layout;
+  if (layout.size() < uris.size()) {
+    layout = CreateGridLayout(width_, height_, uris.size(), options.columns);
+  }
+
+  // Each tile only needs frames of the size of its rect.
+  auto player_options = options.player_options;
+  player_options.adaptive_resolution = true;
+
+  // The tiles must be in place before any of them notifies the wall.
+  tiles_.resize(uris.size());
+  for (size_t i = 0; i < uris.size(); i++) {
+    auto& rect = tiles_[i].rect;
+    rect = layout[i];
+    rect.x = std::clamp(rect.x, 0, width_);
+    rect.y = std::clamp(rect.y, 0, height_);
+    rect.width = std::clamp(rect.width, 0, width_ - rect.x);
+    rect.height = std::clamp(rect.height, 0, height_ - rect.y);
+  }
+  for (size_t i = 0; i < uris.size(); i++) {
+    tiles_[i].player = std::make_unique<GstVideoPlayer>(
+        uris[i], std::make_unique<TileStreamHandler>(this, i),
+        player_options);
+  }
+}
+
+GstVideoWallPlayer::~GstVideoWallPlayer() {
+  // Destroys the tiles first, which stops their notifications.
+  tiles_.clear();
+}
+
+// static
+std::vector<GstVideoWallPlayer::Rect> GstVideoWallPlayer::CreateGridLayout(
+    int32_t width, int32_t height, size_t count, int32_t columns) {
+  std::vector<Rect> layout;
+  if (count == 0) {
+    return layout;
+  }
+  if (columns <= 0) {
+    columns = static_cast<int32_t>(std::ceil(std::sqrt(count)));
+  }
+  const auto rows = static_cast<int32_t>((count + columns - 1) / columns);
+  for (size_t i = 0; i < count; i++) {
+    const auto column = static_cast<int32_t>(i % columns);
+    const auto row = static_cast<int32_t>(i / columns);
+    // Spreads the remainder over the tiles so that the grid fills the wall.
+    Rect rect;
+    rect.x = width * column / columns;
+    rect.y = height * row / rows;
+    rect.width = width * (column + 1) / columns - rect.x;
+    rect.height = height * (row + 1) / rows - rect.y;
+    layout.push_back(rect);
+  }
+  return layout;
+}
+
+GstVideoPlayer* GstVideoWallPlayer::GetTile(size_t index) {
+  if (index >= tiles_.size()) {
+    return nullptr;
+  }
+  return tiles_[index].player.get();
+}
+
+bool GstVideoWallPlayer::Play() {
+  completed_count_ = 0;
+  auto result = true;
+  for (auto& tile : tiles_) {
+    result &= tile.player->Play();
+  }
+  return result;
+}
+
+bool GstVideoWallPlayer::Pause() {
+  auto result = true;
+  for (auto& tile : tiles_) {
+    result &= tile.player->Pause();
+  }
+  return result;
+}
+
+bool GstVideoWallPlayer::SetVolume(double volume) {
+  auto result = true;
+  for (auto& tile : tiles_) {
+    result &= tile.player->SetVolume(volume);
+  }
+  return result;
+}
+
+void GstVideoWallPlayer::SetAutoRepeat(bool auto_repeat) {
+  for (auto& tile : tiles_) {
+    tile.player->SetAutoRepeat(auto_repeat);
+  }
+}
+
+bool GstVideoWallPlayer::IsInitialized() const {
+  return initialized_count_ == tiles_.size();
+}
+
+int64_t GstVideoWallPlayer::GetDuration() {
+  int64_t duration = 0;
+  for (auto& tile : tiles_) {
+    duration = std::max(duration, tile.player->GetDuration());
+  }
+  return duration;
+}
+
+const uint8_t* GstVideoWallPlayer::GetFrameBuffer(int32_t& width,
+                                                  int32_t& height) {
+  // Frames decoded from now on need another notification.
+  is_frame_pending_ = false;
+
+  for (auto& tile : tiles_) {
+    auto* player = tile.player.get();
+    player->SetOutputSizeHint(tile.rect.width, tile.rect.height);
+
+    const auto rendered_count = player->GetRenderedFrameCount();
+    int32_t frame_width = 0;
+    int32_t frame_height = 0;
+    const auto* pixels = player->GetFrameBuffer(frame_width, frame_height);
+    // Keeps the previous frame of the tile if nothing was decoded since.
+    if (pixels && player->GetRenderedFrameCount() != rendered_count) {
+      DrawTile(tile, pixels, frame_width, frame_height);
+    }
+    player->ReleaseFrameBuffer();
+  }
+
+  width = width_;
+  height = height_;
+  return pixels_.get();
+}
+
+void GstVideoWallPlayer::OnTileInitialized() {
+  if (++initialized_count_ == tiles_.size()) {
+    stream_handler_->OnNotifyInitialized();
+  }
+}
+
+void GstVideoWallPlayer::OnTileFrameDecoded() {
+  // The engine fetches all tiles at once, so one notification is enough until
+  // it does.
+  if (!is_frame_pending_.exchange(true)) {
+    stream_handler_->OnNotifyFrameDecoded();
+  }
+}
+
+void GstVideoWallPlayer::OnTileCompleted() {
+  if (++completed_count_ == tiles_.size()) {
+    stream_handler_->OnNotifyCompleted();
+  }
+}
+
+void GstVideoWallPlayer::OnTileBufferingStateChanged(bool is_buffering) {
+  // The wall is buffering while any of the tiles is.
+  if (is_buffering) {
+    if (buffering_count_++ == 0) {
+      stream_handler_->OnNotifyBufferingStateChanged(true);
+    }
+  } else if (buffering_count_ > 0 && --buffering_count_ == 0) {
+    stream_handler_->OnNotifyBufferingStateChanged(false);
+  }
+}
+
+void GstVideoWallPlayer::OnTilePlayingStateChanged(bool is_playing) {
+  // The wall is playing while any of the tiles is.
+  if (is_playing) {
+    if (playing_count_++ == 0) {
+      stream_handler_->OnNotifyPlayingStateChanged(true);
+    }
+  } else if (playing_count_ > 0 && --playing_count_ == 0) {
+    stream_handler_->OnNotifyPlayingStateChanged(false);
+  }
+}
+
+void GstVideoWallPlayer::OnTileError(size_t index, const std::string& message) {
+  stream_handler_->OnNotifyError("Tile " + std::to_string(index) + ": " +
+                                 message);
+}
+
+void GstVideoWallPlayer::FillRect(const Rect& rect) {
+  // Opaque black.
+  static constexpr uint8_t kBackground[] = {0, 0, 0, 255};
+  for (auto y = rect.y; y < rect.y + rect.height; y++) {
+    auto* row = pixels_.get() + (y * width_ + rect.x) * 4;
+    for (auto x = 0; x < rect.width; x++) {
+      std::memcpy(row + x * 4, kBackground, sizeof(kBackground));
+    }
+  }
+}
+
+void GstVideoWallPlayer::DrawTile(Tile& tile, const uint8_t* pixels,
+                                  int32_t width, int32_t height) {
+  const auto& rect = tile.rect;
+  if (rect.width <= 0 || rect.height <= 0 || width <= 0 || height <= 0) {
+    return;
+  }
+
+  // Frames are normally scaled to the tile by the player already. They are
+  // scaled here only until the player has renegotiated, or if it can't.
+  Rect drawn_rect;
+  drawn_rect.width = width;
+  drawn_rect.height = height;
+  if (width > rect.width || height > rect.height) {
+    const auto scale = std::min(static_cast<double>(rect.width) / width,
+                                static_cast<double>(rect.height) / height);
+    drawn_rect.width = std::max(static_cast<int32_t>(width * scale), 1);
+    drawn_rect.height = std::max(static_cast<int32_t>(height * scale), 1);
+  }
+  drawn_rect.x = rect.x + (rect.width - drawn_rect.width) / 2;
+  drawn_rect.y = rect.y + (rect.height - drawn_rect.height) / 2;
+
+  // Clears the borders left by a frame of another size.
+  if (drawn_rect.x != tile.drawn_rect.x || drawn_rect.y != tile.drawn_rect.y ||
+      drawn_rect.width != tile.drawn_rect.width ||
+      drawn_rect.height != tile.drawn_rect.height) {
+    FillRect(rect);
+    tile.drawn_rect = drawn_rect;
+  }
+
+  const auto row_bytes = drawn_rect.width * 4;
+  if (drawn_rect.width == width && drawn_rect.height == height) {
+    for (auto y = 0; y < height; y++) {
+      std::memcpy(
+          pixels_.get() + ((drawn_rect.y + y) * width_ + drawn_rect.x) * 4,
+          pixels + y * width * 4, row_bytes);
+    }
+    return;
+  }
+
+  // Nearest neighbour scaling.
+  for (auto y = 0; y < drawn_rect.height; y++) {
+    const auto* src_row =
+        pixels + static_cast<int64_t>(y) * height / drawn_rect.height * width *
+                     4;
+    auto* dst_row =
+        pixels_.get() + ((drawn_rect.y + y) * width_ + drawn_rect.x) * 4;
+    for (auto x = 0; x < drawn_rect.width; x++) {
+      const auto src_x = static_cast<int64_t>(x) * width / drawn_rect.width;
+      std::memcpy(dst_row + x * 4, src_row + src_x * 4, 4);
+    }
+  }
+}
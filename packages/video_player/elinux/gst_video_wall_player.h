@@ -0,0 +1,113 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_WALL_PLAYER_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_WALL_PLAYER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gst_video_player.h"
+#include "video_player_stream_handler.h"
+
+// Plays several videos as the tiles of a single texture. Each tile is decoded
+// by its own GstVideoPlayer scaled down to the size of the tile, so tiles can
+// still be played, paused and seeked on their own, while the engine uploads
+// one texture and is notified once per composed frame.
+class GstVideoWallPlayer {
+ public:
+  struct Rect {
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+  };
+
+  struct Options {
+    // The size of the composed texture.
+    int32_t width = 1920;
+    int32_t height = 1080;
+    // The area of each tile in the texture. The tiles are laid out in a grid
+    // of |columns| columns if this is empty.
+    std::vector<Rect> layout;
+    // Zero picks the smallest square grid.
+    int32_t columns = 0;
+    // The options of the player of each tile. Adaptive resolution is always
+    // enabled.
+    GstVideoPlayer::Options player_options;
+  };
+
+  GstVideoWallPlayer(const std::vector<std::string>& uris,
+                     std::unique_ptr<VideoPlayerStreamHandler> handler,
+                     const Options& options);
+  ~GstVideoWallPlayer();
+
+  // Prevent copying.
+  GstVideoWallPlayer(GstVideoWallPlayer const&) = delete;
+  GstVideoWallPlayer& operator=(GstVideoWallPlayer const&) = delete;
+
+  // Returns |count| tiles of the same size in a grid of |columns| columns.
+  static std::vector<Rect> CreateGridLayout(int32_t width, int32_t height,
+                                            size_t count, int32_t columns);
+
+  size_t GetTileCount() const { return tiles_.size(); }
+  // Returns the player of the tile at |index|, or nullptr if there is no such
+  // tile.
+  GstVideoPlayer* GetTile(size_t index);
+
+  // Control all tiles at once.
+  bool Play();
+  bool Pause();
+  bool SetVolume(double volume);
+  void SetAutoRepeat(bool auto_repeat);
+
+  // Returns true once all tiles are initialized.
+  bool IsInitialized() const;
+  // Returns the duration of the longest tile.
+  int64_t GetDuration();
+  int32_t GetWidth() const { return width_; }
+  int32_t GetHeight() const { return height_; }
+  // Draws the tiles which have a new frame, and returns the composed frame in
+  // RGBA. This must be called from the raster thread.
+  const uint8_t* GetFrameBuffer(int32_t& width, int32_t& height);
+
+ private:
+  class TileStreamHandler;
+
+  struct Tile {
+    std::unique_ptr<GstVideoPlayer> player;
+    Rect rect;
+    // The area the last frame was drawn in, which is smaller than |rect| if
+    // the aspect ratios differ.
+    Rect drawn_rect;
+  };
+
+  void OnTileInitialized();
+  void OnTileFrameDecoded();
+  void OnTileCompleted();
+  void OnTileBufferingStateChanged(bool is_buffering);
+  void OnTilePlayingStateChanged(bool is_playing);
+  void OnTileError(size_t index, const std::string& message);
+  void FillRect(const Rect& rect);
+  void DrawTile(Tile& tile, const uint8_t* pixels, int32_t width,
+                int32_t height);
+
+  const int32_t width_;
+  const int32_t height_;
+  std::unique_ptr<uint8_t[]> pixels_;
+  std::vector<Tile> tiles_;
+  // Tile events are merged into the events of the wall.
+  std::atomic<size_t> initialized_count_ = 0;
+  std::atomic<size_t> completed_count_ = 0;
+  std::atomic<size_t> buffering_count_ = 0;
+  std::atomic<size_t> playing_count_ = 0;
+  // Whether the engine has been notified of a frame it hasn't fetched yet.
+  std::atomic<bool> is_frame_pending_ = false;
+  std::unique_ptr<VideoPlayerStreamHandler> stream_handler_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_GST_VIDEO_WALL_PLAYER_H_
@@ -8,6 +8,9 @@
 #include <flutter/binary_messenger.h>
 #include <flutter/encodable_value.h>
 
+#include <string>
+#include <vector>
+
 class CreateMessage {
  public:
   CreateMessage() = default;
@@ -37,7 +40,67 @@ class CreateMessage {
 
   std::string GetFormatHint() const { return format_hint_; }
 
+  void SetZeroCopy(bool zeroCopy) { zero_copy_ = zeroCopy; }
+
+  bool GetZeroCopy() const { return zero_copy_; }
+
+  void SetOutputMode(const std::string& outputMode) {
+    output_mode_ = outputMode;
+  }
+
+  std::string GetOutputMode() const { return output_mode_; }
+
+  void SetYuvConversion(bool yuvConversion) { yuv_conversion_ = yuvConversion; }
+
+  bool GetYuvConversion() const { return yuv_conversion_; }
+
+  void SetAdaptiveResolution(bool adaptiveResolution) {
+    adaptive_resolution_ = adaptiveResolution;
+  }
+
+  bool GetAdaptiveResolution() const { return adaptive_resolution_; }
+
+  void SetPrerollTimeout(int64_t prerollTimeout) {
+    preroll_timeout_ = prerollTimeout;
+  }
+
+  int64_t GetPrerollTimeout() const { return preroll_timeout_; }
+
+  void SetValidatePosition(bool validatePosition) {
+    validate_position_ = validatePosition;
+  }
+
+  bool GetValidatePosition() const { return validate_position_; }
+
+  void SetAccurateSeek(bool accurateSeek) { accurate_seek_ = accurateSeek; }
+
+  bool GetAccurateSeek() const { return accurate_seek_; }
+
+  void SetQos(bool qos) { qos_ = qos; }
+
+  bool GetQos() const { return qos_; }
+
+  void SetShareDecoder(bool shareDecoder) { share_decoder_ = shareDecoder; }
+
+  bool GetShareDecoder() const { return share_decoder_; }
+
+  void SetLoopCacheSize(int64_t loopCacheSize) {
+    loop_cache_size_ = loopCacheSize;
+  }
+
+  int64_t GetLoopCacheSize() const { return loop_cache_size_; }
+
+  void SetPlaylist(const std::vector<std::string>& playlist) {
+    playlist_ = playlist;
+  }
+
+  std::vector<std::string> GetPlaylist() const { return playlist_; }
+
   flutter::EncodableValue ToMap() {
+    flutter::EncodableList playlist;
+    for (const auto& item : playlist_) {
+      playlist.push_back(flutter::EncodableValue(item));
+    }
     // todo: Add httpHeaders.
     flutter::EncodableMap map = {
         {flutter::EncodableValue("asset"), flutter::EncodableValue(asset_)},
@@ -45,7 +108,28 @@ class CreateMessage {
         {flutter::EncodableValue("packageName"),
          flutter::EncodableValue(package_name_)},
         {flutter::EncodableValue("formatHint"),
-         flutter::EncodableValue(format_hint_)}};
+         flutter::EncodableValue(format_hint_)},
+        {flutter::EncodableValue("zeroCopy"),
+         flutter::EncodableValue(zero_copy_)},
+        {flutter::EncodableValue("outputMode"),
+         flutter::EncodableValue(output_mode_)},
+        {flutter::EncodableValue("yuvConversion"),
+         flutter::EncodableValue(yuv_conversion_)},
+        {flutter::EncodableValue("adaptiveResolution"),
+         flutter::EncodableValue(adaptive_resolution_)},
+        {flutter::EncodableValue("prerollTimeout"),
+         flutter::EncodableValue(preroll_timeout_)},
+        {flutter::EncodableValue("validatePosition"),
+         flutter::EncodableValue(validate_position_)},
+        {flutter::EncodableValue("accurateSeek"),
+         flutter::EncodableValue(accurate_seek_)},
+        {flutter::EncodableValue("qos"), flutter::EncodableValue(qos_)},
+        {flutter::EncodableValue("shareDecoder"),
+         flutter::EncodableValue(share_decoder_)},
+        {flutter::EncodableValue("loopCacheSize"),
+         flutter::EncodableValue(loop_cache_size_)},
+        {flutter::EncodableValue("playlist"),
+         flutter::EncodableValue(playlist)}};
     return flutter::EncodableValue(map);
   }
 
@@ -75,6 +159,80 @@ class CreateMessage {
       if (std::holds_alternative<std::string>(formatHint)) {
         message.SetFormatHint(std::get<std::string>(formatHint));
       }
+
+      // The following keys are specific to this plugin and optional.
+      flutter::EncodableValue& zeroCopy =
+          map[flutter::EncodableValue("zeroCopy")];
+      if (std::holds_alternative<bool>(zeroCopy)) {
+        message.SetZeroCopy(std::get<bool>(zeroCopy));
+      }
+
+      flutter::EncodableValue& outputMode =
+          map[flutter::EncodableValue("outputMode")];
+      if (std::holds_alternative<std::string>(outputMode)) {
+        message.SetOutputMode(std::get<std::string>(outputMode));
+      }
+
+      flutter::EncodableValue& yuvConversion =
+          map[flutter::EncodableValue("yuvConversion")];
+      if (std::holds_alternative<bool>(yuvConversion)) {
+        message.SetYuvConversion(std::get<bool>(yuvConversion));
+      }
+
+      flutter::EncodableValue& adaptiveResolution =
+          map[flutter::EncodableValue("adaptiveResolution")];
+      if (std::holds_alternative<bool>(adaptiveResolution)) {
+        message.SetAdaptiveResolution(std::get<bool>(adaptiveResolution));
+      }
+
+      flutter::EncodableValue& prerollTimeout =
+          map[flutter::EncodableValue("prerollTimeout")];
+      if (std::holds_alternative<int32_t>(prerollTimeout) ||
+          std::holds_alternative<int64_t>(prerollTimeout)) {
+        message.SetPrerollTimeout(prerollTimeout.LongValue());
+      }
+
+      flutter::EncodableValue& validatePosition =
+          map[flutter::EncodableValue("validatePosition")];
+      if (std::holds_alternative<bool>(validatePosition)) {
+        message.SetValidatePosition(std::get<bool>(validatePosition));
+      }
+
+      flutter::EncodableValue& accurateSeek =
+          map[flutter::EncodableValue("accurateSeek")];
+      if (std::holds_alternative<bool>(accurateSeek)) {
+        message.SetAccurateSeek(std::get<bool>(accurateSeek));
+      }
+
+      flutter::EncodableValue& qos = map[flutter::EncodableValue("qos")];
+      if (std::holds_alternative<bool>(qos)) {
+        message.SetQos(std::get<bool>(qos));
+      }
+
+      flutter::EncodableValue& shareDecoder =
+          map[flutter::EncodableValue("shareDecoder")];
+      if (std::holds_alternative<bool>(shareDecoder)) {
+        message.SetShareDecoder(std::get<bool>(shareDecoder));
+      }
+
+      flutter::EncodableValue& loopCacheSize =
+          map[flutter::EncodableValue("loopCacheSize")];
+      if (std::holds_alternative<int32_t>(loopCacheSize) ||
+          std::holds_alternative<int64_t>(loopCacheSize)) {
+        message.SetLoopCacheSize(loopCacheSize.LongValue());
+      }
+
+      flutter::EncodableValue& playlist =
+          map[flutter::EncodableValue("playlist")];
+      if (std::holds_alternative<flutter::EncodableList>(playlist)) {
+        std::vector<std::string> uris;
+        for (const auto& item : std::get<flutter::EncodableList>(playlist)) {
+          if (std::holds_alternative<std::string>(item)) {
+            uris.push_back(std::get<std::string>(item));
+          }
+        }
+        message.SetPlaylist(uris);
+      }
     }
 
     return message;
@@ -85,6 +243,18 @@ class CreateMessage {
   std::string uri_;
   std::string package_name_;
   std::string format_hint_;
+  bool zero_copy_ = true;
+  std::string output_mode_;
+  bool yuv_conversion_ = false;
+  bool adaptive_resolution_ = false;
+  // A negative value means the default timeout.
+  int64_t preroll_timeout_ = -1;
+  bool validate_position_ = false;
+  bool accurate_seek_ = false;
+  bool qos_ = false;
+  bool share_decoder_ = true;
+  int64_t loop_cache_size_ = 0;
+  std::vector<std::string> playlist_;
 };
 
 #endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CREATE_MESSAGE_H_
@@ -0,0 +1,99 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CREATE_WALL_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CREATE_WALL_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+#include <vector>
+
+class CreateWallMessage {
+ public:
+  CreateWallMessage() = default;
+  ~CreateWallMessage() = default;
+
+  // Prevent copying.
+  CreateWallMessage(CreateWallMessage const&) = default;
+  CreateWallMessage& operator=(CreateWallMessage const&) = default;
+
+  void SetUris(const std::vector<std::string>& uris) { uris_ = uris; }
+
+  std::vector<std::string> GetUris() const { return uris_; }
+
+  void SetWidth(int64_t width) { width_ = width; }
+
+  int64_t GetWidth() const { return width_; }
+
+  void SetHeight(int64_t height) { height_ = height; }
+
+  int64_t GetHeight() const { return height_; }
+
+  void SetColumns(int64_t columns) { columns_ = columns; }
+
+  int64_t GetColumns() const { return columns_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableList uris;
+    for (const auto& uri : uris_) {
+      uris.push_back(flutter::EncodableValue(uri));
+    }
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("uris"), flutter::EncodableValue(uris)},
+        {flutter::EncodableValue("width"), flutter::EncodableValue(width_)},
+        {flutter::EncodableValue("height"), flutter::EncodableValue(height_)},
+        {flutter::EncodableValue("columns"),
+         flutter::EncodableValue(columns_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static CreateWallMessage FromMap(const flutter::EncodableValue& value) {
+    CreateWallMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& uris = map[flutter::EncodableValue("uris")];
+      if (std::holds_alternative<flutter::EncodableList>(uris)) {
+        std::vector<std::string> items;
+        for (const auto& item : std::get<flutter::EncodableList>(uris)) {
+          if (std::holds_alternative<std::string>(item)) {
+            items.push_back(std::get<std::string>(item));
+          }
+        }
+        message.SetUris(items);
+      }
+
+      flutter::EncodableValue& width = map[flutter::EncodableValue("width")];
+      if (std::holds_alternative<int32_t>(width) ||
+          std::holds_alternative<int64_t>(width)) {
+        message.SetWidth(width.LongValue());
+      }
+
+      flutter::EncodableValue& height = map[flutter::EncodableValue("height")];
+      if (std::holds_alternative<int32_t>(height) ||
+          std::holds_alternative<int64_t>(height)) {
+        message.SetHeight(height.LongValue());
+      }
+
+      flutter::EncodableValue& columns =
+          map[flutter::EncodableValue("columns")];
+      if (std::holds_alternative<int32_t>(columns) ||
+          std::holds_alternative<int64_t>(columns)) {
+        message.SetColumns(columns.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  std::vector<std::string> uris_;
+  int64_t width_ = 1920;
+  int64_t height_ = 1080;
+  int64_t columns_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_CREATE_WALL_MESSAGE_H_
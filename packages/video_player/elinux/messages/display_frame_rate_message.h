@@ -0,0 +1,55 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_DISPLAY_FRAME_RATE_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_DISPLAY_FRAME_RATE_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <cmath>
+
+class DisplayFrameRateMessage {
+ public:
+  DisplayFrameRateMessage() = default;
+  ~DisplayFrameRateMessage() = default;
+
+  // Prevent copying.
+  DisplayFrameRateMessage(DisplayFrameRateMessage const&) = default;
+  DisplayFrameRateMessage& operator=(DisplayFrameRateMessage const&) = default;
+
+  void SetFrameRate(int64_t frame_rate) { frame_rate_ = frame_rate; }
+
+  int64_t GetFrameRate() const { return frame_rate_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("frameRate"),
+         flutter::EncodableValue(frame_rate_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static DisplayFrameRateMessage FromMap(const flutter::EncodableValue& value) {
+    DisplayFrameRateMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& frame_rate =
+          map[flutter::EncodableValue("frameRate")];
+      if (std::holds_alternative<int32_t>(frame_rate) ||
+          std::holds_alternative<int64_t>(frame_rate)) {
+        message.SetFrameRate(frame_rate.LongValue());
+      } else if (std::holds_alternative<double>(frame_rate)) {
+        message.SetFrameRate(std::lround(std::get<double>(frame_rate)));
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t frame_rate_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_DISPLAY_FRAME_RATE_MESSAGE_H_
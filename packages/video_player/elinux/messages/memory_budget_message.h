@@ -0,0 +1,49 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MEMORY_BUDGET_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MEMORY_BUDGET_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class MemoryBudgetMessage {
+ public:
+  MemoryBudgetMessage() = default;
+  ~MemoryBudgetMessage() = default;
+
+  // Prevent copying.
+  MemoryBudgetMessage(MemoryBudgetMessage const&) = default;
+  MemoryBudgetMessage& operator=(MemoryBudgetMessage const&) = default;
+
+  void SetBudget(int64_t budget) { budget_ = budget; }
+
+  int64_t GetBudget() const { return budget_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("budget"), flutter::EncodableValue(budget_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static MemoryBudgetMessage FromMap(const flutter::EncodableValue& value) {
+    MemoryBudgetMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& budget = map[flutter::EncodableValue("budget")];
+      if (std::holds_alternative<int32_t>(budget) ||
+          std::holds_alternative<int64_t>(budget)) {
+        message.SetBudget(budget.LongValue());
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t budget_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MEMORY_BUDGET_MESSAGE_H_
@@ -0,0 +1,80 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MEMORY_USAGE_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MEMORY_USAGE_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+#include <vector>
+
+class MemoryUsageMessage {
+ public:
+  // A decoder, which may feed several textures or a tile of a wall.
+  struct Player {
+    int64_t texture_id;
+    // All textures fed by the decoder, including |texture_id|.
+    std::vector<int64_t> texture_ids;
+    // The index of the tile in the wall of |texture_id|, or -1.
+    int64_t tile = -1;
+    int64_t usage;
+    std::string level;
+  };
+
+  MemoryUsageMessage() = default;
+  ~MemoryUsageMessage() = default;
+
+  // Prevent copying.
+  MemoryUsageMessage(MemoryUsageMessage const&) = default;
+  MemoryUsageMessage& operator=(MemoryUsageMessage const&) = default;
+
+  void SetBudget(int64_t budget) { budget_ = budget; }
+
+  int64_t GetBudget() const { return budget_; }
+
+  void SetUsage(int64_t usage) { usage_ = usage; }
+
+  int64_t GetUsage() const { return usage_; }
+
+  void SetPlayers(const std::vector<Player>& players) { players_ = players; }
+
+  std::vector<Player> GetPlayers() const { return players_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableList players;
+    for (const auto& player : players_) {
+      flutter::EncodableList texture_ids;
+      for (const auto texture_id : player.texture_ids) {
+        texture_ids.push_back(flutter::EncodableValue(texture_id));
+      }
+      flutter::EncodableMap item = {
+          {flutter::EncodableValue("textureId"),
+           flutter::EncodableValue(player.texture_id)},
+          {flutter::EncodableValue("textureIds"),
+           flutter::EncodableValue(texture_ids)},
+          {flutter::EncodableValue("tile"),
+           flutter::EncodableValue(player.tile)},
+          {flutter::EncodableValue("usage"),
+           flutter::EncodableValue(player.usage)},
+          {flutter::EncodableValue("level"),
+           flutter::EncodableValue(player.level)}};
+      players.push_back(flutter::EncodableValue(item));
+    }
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("budget"), flutter::EncodableValue(budget_)},
+        {flutter::EncodableValue("usage"), flutter::EncodableValue(usage_)},
+        {flutter::EncodableValue("players"),
+         flutter::EncodableValue(players)}};
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  int64_t budget_ = 0;
+  int64_t usage_ = 0;
+  std::vector<Player> players_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MEMORY_USAGE_MESSAGE_H_
@@ -6,11 +6,23 @@
 #define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MESSAGES_H_
 
 #include "create_message.h"
+#include "create_wall_message.h"
+#include "display_frame_rate_message.h"
 #include "looping_message.h"
+#include "memory_budget_message.h"
+#include "memory_usage_message.h"
 #include "mix_with_others_message.h"
+#include "pipeline_pool_message.h"
+#include "pipeline_pool_stats_message.h"
 #include "playback_speed_message.h"
+#include "player_stats_message.h"
 #include "position_message.h"
+#include "target_fps_message.h"
 #include "texture_message.h"
+#include "thumbnail_request_message.h"
+#include "thumbnail_result_message.h"
+#include "visibility_message.h"
 #include "volume_message.h"
+#include "wall_tile_message.h"
 
 #endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_MESSAGES_H_
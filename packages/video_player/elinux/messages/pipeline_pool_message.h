@@ -0,0 +1,112 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PIPELINE_POOL_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PIPELINE_POOL_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+
+class PipelinePoolMessage {
+ public:
+  PipelinePoolMessage() = default;
+  ~PipelinePoolMessage() = default;
+
+  // Prevent copying.
+  PipelinePoolMessage(PipelinePoolMessage const&) = default;
+  PipelinePoolMessage& operator=(PipelinePoolMessage const&) = default;
+
+  void SetCapacity(int64_t capacity) { capacity_ = capacity; }
+
+  int64_t GetCapacity() const { return capacity_; }
+
+  void SetPrewarmCount(int64_t prewarmCount) { prewarm_count_ = prewarmCount; }
+
+  int64_t GetPrewarmCount() const { return prewarm_count_; }
+
+  void SetOutputMode(const std::string& outputMode) {
+    output_mode_ = outputMode;
+  }
+
+  std::string GetOutputMode() const { return output_mode_; }
+
+  void SetYuvConversion(bool yuvConversion) { yuv_conversion_ = yuvConversion; }
+
+  bool GetYuvConversion() const { return yuv_conversion_; }
+
+  void SetAdaptiveResolution(bool adaptiveResolution) {
+    adaptive_resolution_ = adaptiveResolution;
+  }
+
+  bool GetAdaptiveResolution() const { return adaptive_resolution_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("capacity"),
+         flutter::EncodableValue(capacity_)},
+        {flutter::EncodableValue("prewarmCount"),
+         flutter::EncodableValue(prewarm_count_)},
+        {flutter::EncodableValue("outputMode"),
+         flutter::EncodableValue(output_mode_)},
+        {flutter::EncodableValue("yuvConversion"),
+         flutter::EncodableValue(yuv_conversion_)},
+        {flutter::EncodableValue("adaptiveResolution"),
+         flutter::EncodableValue(adaptive_resolution_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static PipelinePoolMessage FromMap(const flutter::EncodableValue& value) {
+    PipelinePoolMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& capacity =
+          map[flutter::EncodableValue("capacity")];
+      if (std::holds_alternative<int32_t>(capacity) ||
+          std::holds_alternative<int64_t>(capacity)) {
+        message.SetCapacity(capacity.LongValue());
+      }
+
+      flutter::EncodableValue& prewarmCount =
+          map[flutter::EncodableValue("prewarmCount")];
+      if (std::holds_alternative<int32_t>(prewarmCount) ||
+          std::holds_alternative<int64_t>(prewarmCount)) {
+        message.SetPrewarmCount(prewarmCount.LongValue());
+      }
+
+      // The same keys as CreateMessage, which choose the pipelines to
+      // prewarm.
+      flutter::EncodableValue& outputMode =
+          map[flutter::EncodableValue("outputMode")];
+      if (std::holds_alternative<std::string>(outputMode)) {
+        message.SetOutputMode(std::get<std::string>(outputMode));
+      }
+
+      flutter::EncodableValue& yuvConversion =
+          map[flutter::EncodableValue("yuvConversion")];
+      if (std::holds_alternative<bool>(yuvConversion)) {
+        message.SetYuvConversion(std::get<bool>(yuvConversion));
+      }
+
+      flutter::EncodableValue& adaptiveResolution =
+          map[flutter::EncodableValue("adaptiveResolution")];
+      if (std::holds_alternative<bool>(adaptiveResolution)) {
+        message.SetAdaptiveResolution(std::get<bool>(adaptiveResolution));
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t capacity_ = 0;
+  int64_t prewarm_count_ = 0;
+  std::string output_mode_;
+  bool yuv_conversion_ = false;
+  bool adaptive_resolution_ = false;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PIPELINE_POOL_MESSAGE_H_
@@ -0,0 +1,57 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PIPELINE_POOL_STATS_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PIPELINE_POOL_STATS_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class PipelinePoolStatsMessage {
+ public:
+  PipelinePoolStatsMessage() = default;
+  ~PipelinePoolStatsMessage() = default;
+
+  // Prevent copying.
+  PipelinePoolStatsMessage(PipelinePoolStatsMessage const&) = default;
+  PipelinePoolStatsMessage& operator=(PipelinePoolStatsMessage const&) =
+      default;
+
+  void SetCapacity(int64_t capacity) { capacity_ = capacity; }
+
+  int64_t GetCapacity() const { return capacity_; }
+
+  void SetIdleCount(int64_t idleCount) { idle_count_ = idleCount; }
+
+  int64_t GetIdleCount() const { return idle_count_; }
+
+  void SetHitCount(int64_t hitCount) { hit_count_ = hitCount; }
+
+  int64_t GetHitCount() const { return hit_count_; }
+
+  void SetMissCount(int64_t missCount) { miss_count_ = missCount; }
+
+  int64_t GetMissCount() const { return miss_count_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("capacity"),
+         flutter::EncodableValue(capacity_)},
+        {flutter::EncodableValue("idleCount"),
+         flutter::EncodableValue(idle_count_)},
+        {flutter::EncodableValue("hitCount"),
+         flutter::EncodableValue(hit_count_)},
+        {flutter::EncodableValue("missCount"),
+         flutter::EncodableValue(miss_count_)}};
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  int64_t capacity_ = 0;
+  int64_t idle_count_ = 0;
+  int64_t hit_count_ = 0;
+  int64_t miss_count_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PIPELINE_POOL_STATS_MESSAGE_H_
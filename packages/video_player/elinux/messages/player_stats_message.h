@@ -0,0 +1,202 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PLAYER_STATS_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PLAYER_STATS_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <vector>
+
+class PlayerStatsMessage {
+ public:
+  PlayerStatsMessage() = default;
+  ~PlayerStatsMessage() = default;
+
+  // Prevent copying.
+  PlayerStatsMessage(PlayerStatsMessage const&) = default;
+  PlayerStatsMessage& operator=(PlayerStatsMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetDecodedFrames(int64_t decodedFrames) {
+    decoded_frames_ = decodedFrames;
+  }
+
+  int64_t GetDecodedFrames() const { return decoded_frames_; }
+
+  void SetRenderedFrames(int64_t renderedFrames) {
+    rendered_frames_ = renderedFrames;
+  }
+
+  int64_t GetRenderedFrames() const { return rendered_frames_; }
+
+  void SetDroppedFrames(int64_t droppedFrames) {
+    dropped_frames_ = droppedFrames;
+  }
+
+  int64_t GetDroppedFrames() const { return dropped_frames_; }
+
+  void SetOverwrittenFrames(int64_t overwrittenFrames) {
+    overwritten_frames_ = overwrittenFrames;
+  }
+
+  int64_t GetOverwrittenFrames() const { return overwritten_frames_; }
+
+  void SetQosDroppedFrames(int64_t qosDroppedFrames) {
+    qos_dropped_frames_ = qosDroppedFrames;
+  }
+
+  int64_t GetQosDroppedFrames() const { return qos_dropped_frames_; }
+
+  void SetQosEvents(int64_t qosEvents) { qos_events_ = qosEvents; }
+
+  int64_t GetQosEvents() const { return qos_events_; }
+
+  void SetDecoderDroppedFrames(int64_t decoderDroppedFrames) {
+    decoder_dropped_frames_ = decoderDroppedFrames;
+  }
+
+  int64_t GetDecoderDroppedFrames() const { return decoder_dropped_frames_; }
+
+  void SetThrottledFrames(int64_t throttledFrames) {
+    throttled_frames_ = throttledFrames;
+  }
+
+  int64_t GetThrottledFrames() const { return throttled_frames_; }
+
+  void SetDecimatedFrames(int64_t decimatedFrames) {
+    decimated_frames_ = decimatedFrames;
+  }
+
+  int64_t GetDecimatedFrames() const { return decimated_frames_; }
+
+  void SetDecimationRatio(double decimationRatio) {
+    decimation_ratio_ = decimationRatio;
+  }
+
+  double GetDecimationRatio() const { return decimation_ratio_; }
+
+  void SetLoopCachedFrames(int64_t loopCachedFrames) {
+    loop_cached_frames_ = loopCachedFrames;
+  }
+
+  int64_t GetLoopCachedFrames() const { return loop_cached_frames_; }
+
+  void SetLoopCacheSize(int64_t loopCacheSize) {
+    loop_cache_size_ = loopCacheSize;
+  }
+
+  int64_t GetLoopCacheSize() const { return loop_cache_size_; }
+
+  void SetCopiedFrames(int64_t copiedFrames) { copied_frames_ = copiedFrames; }
+
+  int64_t GetCopiedFrames() const { return copied_frames_; }
+
+  void SetCopyTime(int64_t copyTime) { copy_time_ = copyTime; }
+
+  int64_t GetCopyTime() const { return copy_time_; }
+
+  void SetLatencyBucketBounds(const std::vector<int64_t>& bounds) {
+    latency_bucket_bounds_ = bounds;
+  }
+
+  std::vector<int64_t> GetLatencyBucketBounds() const {
+    return latency_bucket_bounds_;
+  }
+
+  void SetLatencyHistogram(const std::vector<int64_t>& histogram) {
+    latency_histogram_ = histogram;
+  }
+
+  std::vector<int64_t> GetLatencyHistogram() const {
+    return latency_histogram_;
+  }
+
+  void SetBitrate(int64_t bitrate) { bitrate_ = bitrate; }
+
+  int64_t GetBitrate() const { return bitrate_; }
+
+  void SetBufferPercent(int64_t bufferPercent) {
+    buffer_percent_ = bufferPercent;
+  }
+
+  int64_t GetBufferPercent() const { return buffer_percent_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableList bounds;
+    for (const auto bound : latency_bucket_bounds_) {
+      bounds.push_back(flutter::EncodableValue(bound));
+    }
+    flutter::EncodableList histogram;
+    for (const auto count : latency_histogram_) {
+      histogram.push_back(flutter::EncodableValue(count));
+    }
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("textureId"),
+         flutter::EncodableValue(texture_id_)},
+        {flutter::EncodableValue("decodedFrames"),
+         flutter::EncodableValue(decoded_frames_)},
+        {flutter::EncodableValue("renderedFrames"),
+         flutter::EncodableValue(rendered_frames_)},
+        {flutter::EncodableValue("droppedFrames"),
+         flutter::EncodableValue(dropped_frames_)},
+        {flutter::EncodableValue("overwrittenFrames"),
+         flutter::EncodableValue(overwritten_frames_)},
+        {flutter::EncodableValue("qosDroppedFrames"),
+         flutter::EncodableValue(qos_dropped_frames_)},
+        {flutter::EncodableValue("qosEvents"),
+         flutter::EncodableValue(qos_events_)},
+        {flutter::EncodableValue("decoderDroppedFrames"),
+         flutter::EncodableValue(decoder_dropped_frames_)},
+        {flutter::EncodableValue("throttledFrames"),
+         flutter::EncodableValue(throttled_frames_)},
+        {flutter::EncodableValue("decimatedFrames"),
+         flutter::EncodableValue(decimated_frames_)},
+        {flutter::EncodableValue("decimationRatio"),
+         flutter::EncodableValue(decimation_ratio_)},
+        {flutter::EncodableValue("loopCachedFrames"),
+         flutter::EncodableValue(loop_cached_frames_)},
+        {flutter::EncodableValue("loopCacheSize"),
+         flutter::EncodableValue(loop_cache_size_)},
+        {flutter::EncodableValue("copiedFrames"),
+         flutter::EncodableValue(copied_frames_)},
+        {flutter::EncodableValue("copyTime"),
+         flutter::EncodableValue(copy_time_)},
+        {flutter::EncodableValue("latencyBucketBounds"),
+         flutter::EncodableValue(bounds)},
+        {flutter::EncodableValue("latencyHistogram"),
+         flutter::EncodableValue(histogram)},
+        {flutter::EncodableValue("bitrate"), flutter::EncodableValue(bitrate_)},
+        {flutter::EncodableValue("bufferPercent"),
+         flutter::EncodableValue(buffer_percent_)}};
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  int64_t decoded_frames_ = 0;
+  int64_t rendered_frames_ = 0;
+  int64_t dropped_frames_ = 0;
+  int64_t overwritten_frames_ = 0;
+  int64_t qos_dropped_frames_ = 0;
+  int64_t qos_events_ = 0;
+  int64_t decoder_dropped_frames_ = 0;
+  int64_t throttled_frames_ = 0;
+  int64_t decimated_frames_ = 0;
+  double decimation_ratio_ = 1.0;
+  int64_t loop_cached_frames_ = 0;
+  int64_t loop_cache_size_ = 0;
+  int64_t copied_frames_ = 0;
+  int64_t copy_time_ = 0;
+  std::vector<int64_t> latency_bucket_bounds_;
+  std::vector<int64_t> latency_histogram_;
+  int64_t bitrate_ = -1;
+  int64_t buffer_percent_ = -1;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_PLAYER_STATS_MESSAGE_H_
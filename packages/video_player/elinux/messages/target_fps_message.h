@@ -0,0 +1,66 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TARGET_FPS_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TARGET_FPS_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+class TargetFpsMessage {
+ public:
+  TargetFpsMessage() = default;
+  ~TargetFpsMessage() = default;
+
+  // Prevent copying.
+  TargetFpsMessage(TargetFpsMessage const&) = default;
+  TargetFpsMessage& operator=(TargetFpsMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetFps(double fps) { fps_ = fps; }
+
+  double GetFps() const { return fps_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("textureId"),
+         flutter::EncodableValue(texture_id_)},
+        {flutter::EncodableValue("fps"), flutter::EncodableValue(fps_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static TargetFpsMessage FromMap(const flutter::EncodableValue& value) {
+    TargetFpsMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& fps = map[flutter::EncodableValue("fps")];
+      if (std::holds_alternative<double>(fps)) {
+        message.SetFps(std::get<double>(fps));
+      } else if (std::holds_alternative<int32_t>(fps) ||
+                 std::holds_alternative<int64_t>(fps)) {
+        message.SetFps(static_cast<double>(fps.LongValue()));
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  // Zero means unlimited.
+  double fps_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_TARGET_FPS_MESSAGE_H_
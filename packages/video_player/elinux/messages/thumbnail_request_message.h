@@ -0,0 +1,103 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_THUMBNAIL_REQUEST_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_THUMBNAIL_REQUEST_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+
+class ThumbnailRequestMessage {
+ public:
+  ThumbnailRequestMessage() = default;
+  ~ThumbnailRequestMessage() = default;
+
+  // Prevent copying.
+  ThumbnailRequestMessage(ThumbnailRequestMessage const&) = default;
+  ThumbnailRequestMessage& operator=(ThumbnailRequestMessage const&) = default;
+
+  void SetUri(const std::string& uri) { uri_ = uri; }
+
+  std::string GetUri() const { return uri_; }
+
+  void SetPosition(int64_t position) { position_ = position; }
+
+  int64_t GetPosition() const { return position_; }
+
+  void SetMaxWidth(int64_t maxWidth) { max_width_ = maxWidth; }
+
+  int64_t GetMaxWidth() const { return max_width_; }
+
+  void SetMaxHeight(int64_t maxHeight) { max_height_ = maxHeight; }
+
+  int64_t GetMaxHeight() const { return max_height_; }
+
+  void SetFormat(const std::string& format) { format_ = format; }
+
+  std::string GetFormat() const { return format_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("uri"), flutter::EncodableValue(uri_)},
+        {flutter::EncodableValue("position"),
+         flutter::EncodableValue(position_)},
+        {flutter::EncodableValue("maxWidth"),
+         flutter::EncodableValue(max_width_)},
+        {flutter::EncodableValue("maxHeight"),
+         flutter::EncodableValue(max_height_)},
+        {flutter::EncodableValue("format"), flutter::EncodableValue(format_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static ThumbnailRequestMessage FromMap(const flutter::EncodableValue& value) {
+    ThumbnailRequestMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& uri = map[flutter::EncodableValue("uri")];
+      if (std::holds_alternative<std::string>(uri)) {
+        message.SetUri(std::get<std::string>(uri));
+      }
+
+      flutter::EncodableValue& position =
+          map[flutter::EncodableValue("position")];
+      if (std::holds_alternative<int32_t>(position) ||
+          std::holds_alternative<int64_t>(position)) {
+        message.SetPosition(position.LongValue());
+      }
+
+      flutter::EncodableValue& maxWidth =
+          map[flutter::EncodableValue("maxWidth")];
+      if (std::holds_alternative<int32_t>(maxWidth) ||
+          std::holds_alternative<int64_t>(maxWidth)) {
+        message.SetMaxWidth(maxWidth.LongValue());
+      }
+
+      flutter::EncodableValue& maxHeight =
+          map[flutter::EncodableValue("maxHeight")];
+      if (std::holds_alternative<int32_t>(maxHeight) ||
+          std::holds_alternative<int64_t>(maxHeight)) {
+        message.SetMaxHeight(maxHeight.LongValue());
+      }
+
+      flutter::EncodableValue& format = map[flutter::EncodableValue("format")];
+      if (std::holds_alternative<std::string>(format)) {
+        message.SetFormat(std::get<std::string>(format));
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  std::string uri_;
+  int64_t position_ = 0;
+  int64_t max_width_ = 0;
+  int64_t max_height_ = 0;
+  std::string format_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_THUMBNAIL_REQUEST_MESSAGE_H_
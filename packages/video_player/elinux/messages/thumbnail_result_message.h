@@ -0,0 +1,59 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_THUMBNAIL_RESULT_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_THUMBNAIL_RESULT_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+#include <vector>
+
+class ThumbnailResultMessage {
+ public:
+  ThumbnailResultMessage() = default;
+  ~ThumbnailResultMessage() = default;
+
+  // Prevent copying.
+  ThumbnailResultMessage(ThumbnailResultMessage const&) = default;
+  ThumbnailResultMessage& operator=(ThumbnailResultMessage const&) = default;
+
+  void SetWidth(int64_t width) { width_ = width; }
+
+  int64_t GetWidth() const { return width_; }
+
+  void SetHeight(int64_t height) { height_ = height; }
+
+  int64_t GetHeight() const { return height_; }
+
+  void SetData(std::vector<uint8_t> data) { data_ = std::move(data); }
+
+  const std::vector<uint8_t>& GetData() const { return data_; }
+
+  void SetError(const std::string& error) { error_ = error; }
+
+  std::string GetError() const { return error_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("width"), flutter::EncodableValue(width_)},
+        {flutter::EncodableValue("height"), flutter::EncodableValue(height_)},
+        {flutter::EncodableValue("data"), flutter::EncodableValue(data_)}};
+    // Only failed requests have an error.
+    if (!error_.empty()) {
+      map.emplace(flutter::EncodableValue("error"),
+                  flutter::EncodableValue(error_));
+    }
+    return flutter::EncodableValue(map);
+  }
+
+ private:
+  int64_t width_ = 0;
+  int64_t height_ = 0;
+  std::vector<uint8_t> data_;
+  std::string error_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_THUMBNAIL_RESULT_MESSAGE_H_
@@ -0,0 +1,117 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_WALL_TILE_MESSAGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_WALL_TILE_MESSAGE_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <string>
+
+class WallTileMessage {
+ public:
+  WallTileMessage() = default;
+  ~WallTileMessage() = default;
+
+  // Prevent copying.
+  WallTileMessage(WallTileMessage const&) = default;
+  WallTileMessage& operator=(WallTileMessage const&) = default;
+
+  void SetTextureId(int64_t texture_id) { texture_id_ = texture_id; }
+
+  int64_t GetTextureId() const { return texture_id_; }
+
+  void SetTile(int64_t tile) { tile_ = tile; }
+
+  int64_t GetTile() const { return tile_; }
+
+  void SetCommand(const std::string& command) { command_ = command; }
+
+  std::string GetCommand() const { return command_; }
+
+  void SetPosition(int64_t position) { position_ = position; }
+
+  int64_t GetPosition() const { return position_; }
+
+  void SetVolume(double volume) { volume_ = volume; }
+
+  double GetVolume() const { return volume_; }
+
+  void SetIsLooping(bool isLooping) { is_looping_ = isLooping; }
+
+  bool GetIsLooping() const { return is_looping_; }
+
+  flutter::EncodableValue ToMap() {
+    flutter::EncodableMap map = {
+        {flutter::EncodableValue("textureId"),
+         flutter::EncodableValue(texture_id_)},
+        {flutter::EncodableValue("tile"), flutter::EncodableValue(tile_)},
+        {flutter::EncodableValue("command"),
+         flutter::EncodableValue(command_)},
+        {flutter::EncodableValue("position"),
+         flutter::EncodableValue(position_)},
+        {flutter::EncodableValue("volume"), flutter::EncodableValue(volume_)},
+        {flutter::EncodableValue("isLooping"),
+         flutter::EncodableValue(is_looping_)}};
+    return flutter::EncodableValue(map);
+  }
+
+  static WallTileMessage FromMap(const flutter::EncodableValue& value) {
+    WallTileMessage message;
+    if (std::holds_alternative<flutter::EncodableMap>(value)) {
+      auto map = std::get<flutter::EncodableMap>(value);
+
+      flutter::EncodableValue& texture_id =
+          map[flutter::EncodableValue("textureId")];
+      if (std::holds_alternative<int32_t>(texture_id) ||
+          std::holds_alternative<int64_t>(texture_id)) {
+        message.SetTextureId(texture_id.LongValue());
+      }
+
+      flutter::EncodableValue& tile = map[flutter::EncodableValue("tile")];
+      if (std::holds_alternative<int32_t>(tile) ||
+          std::holds_alternative<int64_t>(tile)) {
+        message.SetTile(tile.LongValue());
+      }
+
+      flutter::EncodableValue& command =
+          map[flutter::EncodableValue("command")];
+      if (std::holds_alternative<std::string>(command)) {
+        message.SetCommand(std::get<std::string>(command));
+      }
+
+      flutter::EncodableValue& position =
+          map[flutter::EncodableValue("position")];
+      if (std::holds_alternative<int32_t>(position) ||
+          std::holds_alternative<int64_t>(position)) {
+        message.SetPosition(position.LongValue());
+      }
+
+      flutter::EncodableValue& volume = map[flutter::EncodableValue("volume")];
+      if (std::holds_alternative<double>(volume)) {
+        message.SetVolume(std::get<double>(volume));
+      }
+
+      flutter::EncodableValue& isLooping =
+          map[flutter::EncodableValue("isLooping")];
+      if (std::holds_alternative<bool>(isLooping)) {
+        message.SetIsLooping(std::get<bool>(isLooping));
+      }
+    }
+
+    return message;
+  }
+
+ private:
+  int64_t texture_id_ = 0;
+  // The index of the tile, or -1 for all tiles.
+  int64_t tile_ = -1;
+  std::string command_;
+  int64_t position_ = 0;
+  double volume_ = 1.0;
+  bool is_looping_ = false;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_MESSAGES_WALL_TILE_MESSAGE_H_
@@ -0,0 +1,396 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "video_color_converter.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VIDEO_COLOR_CONVERTER_X86
+#endif
+
+namespace {
+
+// Fixed-point coefficients with 6 fractional bits. The luma is scaled with a
+// 16-bit multiplier, (y * 257 * y_gain) >> 16, for better precision. Every
+// intermediate value fits in 16 bits, except for values which are clamped to
+// 255 anyway, so the SIMD kernels can use saturating 16-bit arithmetic and
+// still match the scalar kernel bit by bit.
+struct Coefficients {
+  uint16_t y_gain;
+  int16_t y_bias;
+  int16_t rv;
+  int16_t gu;
+  int16_t gv;
+  int16_t bu;
+};
+
+constexpr Coefficients kBt601LimitedRange = {19003, 1192, 102, 25, 52, 129};
+constexpr Coefficients kBt709LimitedRange = {19003, 1192, 115, 14, 34, 135};
+constexpr Coefficients kBt601FullRange = {16320, 0, 90, 22, 46, 113};
+constexpr Coefficients kBt709FullRange = {16320, 0, 101, 12, 30, 119};
+
+const Coefficients& GetCoefficients(VideoColorConverter::ColorMatrix matrix,
+                                    bool full_range) {
+  if (matrix == VideoColorConverter::ColorMatrix::kBt709) {
+    return full_range ? kBt709FullRange : kBt709LimitedRange;
+  }
+  return full_range ? kBt601FullRange : kBt601LimitedRange;
+}
+
+// Converts a row of pixels. |src_u| and |src_v| point to the same row of
+// interleaved chroma samples for NV12.
+using ConvertRowFunc = void (*)(const uint8_t* src_y, const uint8_t* src_u,
+                                const uint8_t* src_v, uint8_t* dest,
+                                int32_t x, int32_t width,
+                                const Coefficients& c);
+
+inline uint8_t Clamp(int32_t value) {
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+inline void YuvToRgba(int32_t y, int32_t u, int32_t v, uint8_t* dest,
+                      const Coefficients& c) {
+  const int32_t yc =
+      static_cast<int32_t>((static_cast<uint32_t>(y) * 257 * c.y_gain) >> 16) -
+      c.y_bias;
+  const int32_t uc = u - 128;
+  const int32_t vc = v - 128;
+  dest[0] = Clamp((yc + c.rv * vc + 32) >> 6);
+  dest[1] = Clamp((yc - c.gu * uc - c.gv * vc + 32) >> 6);
+  dest[2] = Clamp((yc + c.bu * uc + 32) >> 6);
+  dest[3] = 255;
+}
+
+void ConvertRowI420Scalar(const uint8_t* src_y, const uint8_t* src_u,
+                          const uint8_t* src_v, uint8_t* dest, int32_t x,
+                          int32_t width, const Coefficients& c) {
+  for (; x < width; x++) {
+    YuvToRgba(src_y[x], src_u[x / 2], src_v[x / 2], dest + x * 4, c);
+  }
+}
+
+void ConvertRowNV12Scalar(const uint8_t* src_y, const uint8_t* src_uv,
+                          const uint8_t*, uint8_t* dest, int32_t x,
+                          int32_t width, const Coefficients& c) {
+  for (; x < width; x++) {
+    const auto* uv = src_uv + (x / 2) * 2;
+    YuvToRgba(src_y[x], uv[0], uv[1], dest + x * 4, c);
+  }
+}
+
+#ifdef VIDEO_COLOR_CONVERTER_X86
+// Computes R, G and B of 8 pixels from 16-bit Y, U and V values.
+__attribute__((target("sse2"))) inline void YuvToRgbSse2(
+    __m128i y, __m128i u, __m128i v, const Coefficients& c, __m128i& r,
+    __m128i& g, __m128i& b) {
+  const auto bias = _mm_set1_epi16(128);
+  const auto round = _mm_set1_epi16(32);
+  const auto yc = _mm_sub_epi16(
+      _mm_mulhi_epu16(_mm_or_si128(y, _mm_slli_epi16(y, 8)),
+                      _mm_set1_epi16(static_cast<int16_t>(c.y_gain))),
+      _mm_set1_epi16(c.y_bias));
+  const auto uc = _mm_sub_epi16(u, bias);
+  const auto vc = _mm_sub_epi16(v, bias);
+  r = _mm_adds_epi16(yc, _mm_mullo_epi16(vc, _mm_set1_epi16(c.rv)));
+  g = _mm_subs_epi16(yc, _mm_mullo_epi16(uc, _mm_set1_epi16(c.gu)));
+  g = _mm_subs_epi16(g, _mm_mullo_epi16(vc, _mm_set1_epi16(c.gv)));
+  b = _mm_adds_epi16(yc, _mm_mullo_epi16(uc, _mm_set1_epi16(c.bu)));
+  r = _mm_srai_epi16(_mm_adds_epi16(r, round), 6);
+  g = _mm_srai_epi16(_mm_adds_epi16(g, round), 6);
+  b = _mm_srai_epi16(_mm_adds_epi16(b, round), 6);
+}
+
+// Converts 16 pixels. |u| and |v| hold the 8 chroma samples as 16-bit values.
+__attribute__((target("sse2"))) inline void Convert16PixelsSse2(
+    const uint8_t* src_y, __m128i u, __m128i v, uint8_t* dest,
+    const Coefficients& c) {
+  const auto zero = _mm_setzero_si128();
+  const auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_y));
+
+  // Each chroma sample covers two horizontal pixels.
+  __m128i r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+  YuvToRgbSse2(_mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi16(u, u),
+               _mm_unpacklo_epi16(v, v), c, r_lo, g_lo, b_lo);
+  YuvToRgbSse2(_mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi16(u, u),
+               _mm_unpackhi_epi16(v, v), c, r_hi, g_hi, b_hi);
+
+  const auto r = _mm_packus_epi16(r_lo, r_hi);
+  const auto g = _mm_packus_epi16(g_lo, g_hi);
+  const auto b = _mm_packus_epi16(b_lo, b_hi);
+  const auto a = _mm_set1_epi8(-1);
+  const auto rg_lo = _mm_unpacklo_epi8(r, g);
+  const auto rg_hi = _mm_unpackhi_epi8(r, g);
+  const auto ba_lo = _mm_unpacklo_epi8(b, a);
+  const auto ba_hi = _mm_unpackhi_epi8(b, a);
+  auto* out = reinterpret_cast<__m128i*>(dest);
+  _mm_storeu_si128(out, _mm_unpacklo_epi16(rg_lo, ba_lo));
+  _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(rg_lo, ba_lo));
+  _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(rg_hi, ba_hi));
+  _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(rg_hi, ba_hi));
+}
+
+__attribute__((target("sse2"))) void ConvertRowI420Sse2(
+    const uint8_t* src_y, const uint8_t* src_u, const uint8_t* src_v,
+    uint8_t* dest, int32_t x, int32_t width, const Coefficients& c) {
+  const auto zero = _mm_setzero_si128();
+  for (; x + 16 <= width; x += 16) {
+    const auto u = _mm_loadl_epi64(
+        reinterpret_cast<const __m128i*>(src_u + x / 2));
+    const auto v = _mm_loadl_epi64(
+        reinterpret_cast<const __m128i*>(src_v + x / 2));
+    Convert16PixelsSse2(src_y + x, _mm_unpacklo_epi8(u, zero),
+                        _mm_unpacklo_epi8(v, zero), dest + x * 4, c);
+  }
+  ConvertRowI420Scalar(src_y, src_u, src_v, dest, x, width, c);
+}
+
+__attribute__((target("sse2"))) void ConvertRowNV12Sse2(
+    const uint8_t* src_y, const uint8_t* src_uv, const uint8_t* src_v,
+    uint8_t* dest, int32_t x, int32_t width, const Coefficients& c) {
+  const auto mask = _mm_set1_epi16(0x00ff);
+  for (; x + 16 <= width; x += 16) {
+    const auto uv =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_uv + x));
+    Convert16PixelsSse2(src_y + x, _mm_and_si128(uv, mask),
+                        _mm_srli_epi16(uv, 8), dest + x * 4, c);
+  }
+  ConvertRowNV12Scalar(src_y, src_uv, src_v, dest, x, width, c);
+}
+
+// Computes R, G and B of 16 pixels from 16-bit Y, U and V values.
+__attribute__((target("avx2"))) inline void YuvToRgbAvx2(
+    __m256i y, __m256i u, __m256i v, const Coefficients& c, __m256i& r,
+    __m256i& g, __m256i& b) {
+  const auto bias = _mm256_set1_epi16(128);
+  const auto round = _mm256_set1_epi16(32);
+  const auto yc = _mm256_sub_epi16(
+      _mm256_mulhi_epu16(_mm256_or_si256(y, _mm256_slli_epi16(y, 8)),
+                         _mm256_set1_epi16(static_cast<int16_t>(c.y_gain))),
+      _mm256_set1_epi16(c.y_bias));
+  const auto uc = _mm256_sub_epi16(u, bias);
+  const auto vc = _mm256_sub_epi16(v, bias);
+  r = _mm256_adds_epi16(yc, _mm256_mullo_epi16(vc, _mm256_set1_epi16(c.rv)));
+  g = _mm256_subs_epi16(yc, _mm256_mullo_epi16(uc, _mm256_set1_epi16(c.gu)));
+  g = _mm256_subs_epi16(g, _mm256_mullo_epi16(vc, _mm256_set1_epi16(c.gv)));
+  b = _mm256_adds_epi16(yc, _mm256_mullo_epi16(uc, _mm256_set1_epi16(c.bu)));
+  r = _mm256_srai_epi16(_mm256_adds_epi16(r, round), 6);
+  g = _mm256_srai_epi16(_mm256_adds_epi16(g, round), 6);
+  b = _mm256_srai_epi16(_mm256_adds_epi16(b, round), 6);
+}
+
+// Converts 32 pixels. |u| and |v| hold the 16 chroma samples as 16-bit values.
+__attribute__((target("avx2"))) inline void Convert32PixelsAvx2(
+    const uint8_t* src_y, __m256i u, __m256i v, uint8_t* dest,
+    const Coefficients& c) {
+  const auto y_lo = _mm256_cvtepu8_epi16(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_y)));
+  const auto y_hi = _mm256_cvtepu8_epi16(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_y + 16)));
+
+  // Unpacking works within 128-bit lanes, so the duplicated chroma samples
+  // are put back in pixel order across the lanes.
+  const auto u_0 = _mm256_unpacklo_epi16(u, u);
+  const auto u_1 = _mm256_unpackhi_epi16(u, u);
+  const auto v_0 = _mm256_unpacklo_epi16(v, v);
+  const auto v_1 = _mm256_unpackhi_epi16(v, v);
+  __m256i r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+  YuvToRgbAvx2(y_lo, _mm256_permute2x128_si256(u_0, u_1, 0x20),
+               _mm256_permute2x128_si256(v_0, v_1, 0x20), c, r_lo, g_lo, b_lo);
+  YuvToRgbAvx2(y_hi, _mm256_permute2x128_si256(u_0, u_1, 0x31),
+               _mm256_permute2x128_si256(v_0, v_1, 0x31), c, r_hi, g_hi, b_hi);
+
+  // Packing also works within 128-bit lanes, so the 64-bit quarters are
+  // reordered to put the pixels back in order.
+  const auto r =
+      _mm256_permute4x64_epi64(_mm256_packus_epi16(r_lo, r_hi), 0xd8);
+  const auto g =
+      _mm256_permute4x64_epi64(_mm256_packus_epi16(g_lo, g_hi), 0xd8);
+  const auto b =
+      _mm256_permute4x64_epi64(_mm256_packus_epi16(b_lo, b_hi), 0xd8);
+  const auto a = _mm256_set1_epi8(-1);
+  const auto rg_lo = _mm256_unpacklo_epi8(r, g);
+  const auto rg_hi = _mm256_unpackhi_epi8(r, g);
+  const auto ba_lo = _mm256_unpacklo_epi8(b, a);
+  const auto ba_hi = _mm256_unpackhi_epi8(b, a);
+  const auto rgba_0 = _mm256_unpacklo_epi16(rg_lo, ba_lo);
+  const auto rgba_1 = _mm256_unpackhi_epi16(rg_lo, ba_lo);
+  const auto rgba_2 = _mm256_unpacklo_epi16(rg_hi, ba_hi);
+  const auto rgba_3 = _mm256_unpackhi_epi16(rg_hi, ba_hi);
+  auto* out = reinterpret_cast<__m256i*>(dest);
+  _mm256_storeu_si256(out, _mm256_permute2x128_si256(rgba_0, rgba_1, 0x20));
+  _mm256_storeu_si256(out + 1,
+                      _mm256_permute2x128_si256(rgba_2, rgba_3, 0x20));
+  _mm256_storeu_si256(out + 2,
+                      _mm256_permute2x128_si256(rgba_0, rgba_1, 0x31));
+  _mm256_storeu_si256(out + 3,
+                      _mm256_permute2x128_si256(rgba_2, rgba_3, 0x31));
+}
+
+__attribute__((target("avx2"))) void ConvertRowI420Avx2(
+    const uint8_t* src_y, const uint8_t* src_u, const uint8_t* src_v,
+    uint8_t* dest, int32_t x, int32_t width, const Coefficients& c) {
+  for (; x + 32 <= width; x += 32) {
+    const auto u = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_u + x / 2)));
+    const auto v = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_v + x / 2)));
+    Convert32PixelsAvx2(src_y + x, u, v, dest + x * 4, c);
+  }
+  ConvertRowI420Sse2(src_y, src_u, src_v, dest, x, width, c);
+}
+
+__attribute__((target("avx2"))) void ConvertRowNV12Avx2(
+    const uint8_t* src_y, const uint8_t* src_uv, const uint8_t* src_v,
+    uint8_t* dest, int32_t x, int32_t width, const Coefficients& c) {
+  const auto mask = _mm256_set1_epi16(0x00ff);
+  for (; x + 32 <= width; x += 32) {
+    const auto uv =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src_uv + x));
+    Convert32PixelsAvx2(src_y + x, _mm256_and_si256(uv, mask),
+                        _mm256_srli_epi16(uv, 8), dest + x * 4, c);
+  }
+  ConvertRowNV12Sse2(src_y, src_uv, src_v, dest, x, width, c);
+}
+#endif  // VIDEO_COLOR_CONVERTER_X86
+
+ConvertRowFunc GetConvertRowI420(VideoColorConverter::Kernel kernel) {
+  switch (kernel) {
+#ifdef VIDEO_COLOR_CONVERTER_X86
+    case VideoColorConverter::Kernel::kAvx2:
+      return ConvertRowI420Avx2;
+    case VideoColorConverter::Kernel::kSse2:
+      return ConvertRowI420Sse2;
+#endif  // VIDEO_COLOR_CONVERTER_X86
+    default:
+      return ConvertRowI420Scalar;
+  }
+}
+
+ConvertRowFunc GetConvertRowNV12(VideoColorConverter::Kernel kernel) {
+  switch (kernel) {
+#ifdef VIDEO_COLOR_CONVERTER_X86
+    case VideoColorConverter::Kernel::kAvx2:
+      return ConvertRowNV12Avx2;
+    case VideoColorConverter::Kernel::kSse2:
+      return ConvertRowNV12Sse2;
+#endif  // VIDEO_COLOR_CONVERTER_X86
+    default:
+      return ConvertRowNV12Scalar;
+  }
+}
+
+}  // namespace
+
+VideoColorConverter::VideoColorConverter() : kernel_(DetectKernel()) {}
+
+VideoColorConverter::VideoColorConverter(Kernel kernel)
+    : kernel_(IsKernelSupported(kernel) ? kernel : DetectKernel()) {}
+
+// static
+VideoColorConverter::Kernel VideoColorConverter::DetectKernel() {
+  if (IsKernelSupported(Kernel::kAvx2)) {
+    return Kernel::kAvx2;
+  }
+  if (IsKernelSupported(Kernel::kSse2)) {
+    return Kernel::kSse2;
+  }
+  return Kernel::kScalar;
+}
+
+// static
+bool VideoColorConverter::IsKernelSupported(Kernel kernel) {
+  switch (kernel) {
+#ifdef VIDEO_COLOR_CONVERTER_X86
+    case Kernel::kAvx2:
+      return __builtin_cpu_supports("avx2");
+    case Kernel::kSse2:
+      return __builtin_cpu_supports("sse2");
+#endif  // VIDEO_COLOR_CONVERTER_X86
+    case Kernel::kScalar:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+const char* VideoColorConverter::GetKernelName(Kernel kernel) {
+  switch (kernel) {
+    case Kernel::kAvx2:
+      return "avx2";
+    case Kernel::kSse2:
+      return "sse2";
+    default:
+      return "scalar";
+  }
+}
+
+// static
+bool VideoColorConverter::IsSupportedFormat(GstVideoFormat format) {
+  return format == GST_VIDEO_FORMAT_I420 || format == GST_VIDEO_FORMAT_NV12;
+}
+
+bool VideoColorConverter::Convert(const GstVideoFrame* frame, uint8_t* dest,
+                                  int32_t dest_stride) const {
+  const auto* info = &frame->info;
+  const auto matrix = info->colorimetry.matrix == GST_VIDEO_COLOR_MATRIX_BT709
+                          ? ColorMatrix::kBt709
+                          : ColorMatrix::kBt601;
+  const auto full_range =
+      info->colorimetry.range == GST_VIDEO_COLOR_RANGE_0_255;
+  const auto* src_y =
+      reinterpret_cast<const uint8_t*>(GST_VIDEO_FRAME_PLANE_DATA(frame, 0));
+  const auto* src_u =
+      reinterpret_cast<const uint8_t*>(GST_VIDEO_FRAME_PLANE_DATA(frame, 1));
+
+  switch (GST_VIDEO_FRAME_FORMAT(frame)) {
+    case GST_VIDEO_FORMAT_I420:
+      ConvertI420(src_y, GST_VIDEO_FRAME_PLANE_STRIDE(frame, 0), src_u,
+                  GST_VIDEO_FRAME_PLANE_STRIDE(frame, 1),
+                  reinterpret_cast<const uint8_t*>(
+                      GST_VIDEO_FRAME_PLANE_DATA(frame, 2)),
+                  GST_VIDEO_FRAME_PLANE_STRIDE(frame, 2), dest, dest_stride,
+                  GST_VIDEO_FRAME_WIDTH(frame), GST_VIDEO_FRAME_HEIGHT(frame),
+                  matrix, full_range);
+      return true;
+    case GST_VIDEO_FORMAT_NV12:
+      ConvertNV12(src_y, GST_VIDEO_FRAME_PLANE_STRIDE(frame, 0), src_u,
+                  GST_VIDEO_FRAME_PLANE_STRIDE(frame, 1), dest, dest_stride,
+                  GST_VIDEO_FRAME_WIDTH(frame), GST_VIDEO_FRAME_HEIGHT(frame),
+                  matrix, full_range);
+      return true;
+    default:
+      return false;
+  }
+}
+
+void VideoColorConverter::ConvertI420(
+    const uint8_t* src_y, int32_t src_y_stride, const uint8_t* src_u,
+    int32_t src_u_stride, const uint8_t* src_v, int32_t src_v_stride,
+    uint8_t* dest, int32_t dest_stride, int32_t width, int32_t height,
+    ColorMatrix matrix, bool full_range) const {
+  const auto convert_row = GetConvertRowI420(kernel_);
+  const auto& c = GetCoefficients(matrix, full_range);
+  for (int32_t y = 0; y < height; y++) {
+    convert_row(src_y + y * src_y_stride, src_u + (y / 2) * src_u_stride,
+                src_v + (y / 2) * src_v_stride, dest + y * dest_stride, 0,
+                width, c);
+  }
+}
+
+void VideoColorConverter::ConvertNV12(const uint8_t* src_y,
+                                      int32_t src_y_stride,
+                                      const uint8_t* src_uv,
+                                      int32_t src_uv_stride, uint8_t* dest,
+                                      int32_t dest_stride, int32_t width,
+                                      int32_t height, ColorMatrix matrix,
+                                      bool full_range) const {
+  const auto convert_row = GetConvertRowNV12(kernel_);
+  const auto& c = GetCoefficients(matrix, full_range);
+  for (int32_t y = 0; y < height; y++) {
+    const auto* uv = src_uv + (y / 2) * src_uv_stride;
+    convert_row(src_y + y * src_y_stride, uv, uv, dest + y * dest_stride, 0,
+                width, c);
+  }
+}
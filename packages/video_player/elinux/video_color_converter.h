@@ -0,0 +1,61 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_COLOR_CONVERTER_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_COLOR_CONVERTER_H_
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include <cstdint>
+
+// Converts I420 and NV12 frames into RGBA. The fastest kernel supported by the
+// CPU (AVX2, SSE2 or scalar) is picked at runtime, and all kernels produce
+// bit-exact results.
+class VideoColorConverter {
+ public:
+  enum class Kernel {
+    kScalar,
+    kSse2,
+    kAvx2,
+  };
+
+  enum class ColorMatrix {
+    kBt601,
+    kBt709,
+  };
+
+  // Uses the fastest kernel supported by the CPU.
+  VideoColorConverter();
+  explicit VideoColorConverter(Kernel kernel);
+  ~VideoColorConverter() = default;
+
+  static Kernel DetectKernel();
+  static bool IsKernelSupported(Kernel kernel);
+  static const char* GetKernelName(Kernel kernel);
+  static bool IsSupportedFormat(GstVideoFormat format);
+
+  Kernel GetKernel() const { return kernel_; }
+
+  // Converts a mapped I420 or NV12 |frame| into RGBA pixels of the same size.
+  // The color matrix and range are taken from the colorimetry of the frame.
+  bool Convert(const GstVideoFrame* frame, uint8_t* dest,
+               int32_t dest_stride) const;
+
+  void ConvertI420(const uint8_t* src_y, int32_t src_y_stride,
+                   const uint8_t* src_u, int32_t src_u_stride,
+                   const uint8_t* src_v, int32_t src_v_stride, uint8_t* dest,
+                   int32_t dest_stride, int32_t width, int32_t height,
+                   ColorMatrix matrix, bool full_range) const;
+
+  void ConvertNV12(const uint8_t* src_y, int32_t src_y_stride,
+                   const uint8_t* src_uv, int32_t src_uv_stride, uint8_t* dest,
+                   int32_t dest_stride, int32_t width, int32_t height,
+                   ColorMatrix matrix, bool full_range) const;
+
+ private:
+  Kernel kernel_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_COLOR_CONVERTER_H_
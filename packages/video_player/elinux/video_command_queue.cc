@@ -0,0 +1,69 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "video_command_queue.h"
+
+#include <algorithm>
+#include <utility>
+
+VideoCommandQueue::~VideoCommandQueue() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  // Every caller is answered, even if its command never runs.
+  for (auto& command : commands_) {
+    for (auto& callback : command.callbacks) {
+      callback();
+    }
+  }
+}
+
+void VideoCommandQueue::Post(Kind kind, Task task, Callback callback) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Command command{kind, std::move(task), {}};
+    auto itr = std::find_if(
+        commands_.begin(), commands_.end(),
+        [kind](const Command& pending) { return pending.kind == kind; });
+    if (itr != commands_.end()) {
+      command.callbacks = std::move(itr->callbacks);
+      commands_.erase(itr);
+    }
+    if (callback) {
+      command.callbacks.push_back(std::move(callback));
+    }
+    commands_.push_back(std::move(command));
+
+    // The thread is started by the first command.
+    if (!thread_.joinable()) {
+      thread_ = std::thread(&VideoCommandQueue::Run, this);
+    }
+  }
+  cv_.notify_all();
+}
+
+void VideoCommandQueue::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return is_stopped_ || !commands_.empty(); });
+    if (is_stopped_) {
+      return;
+    }
+
+    auto command = std::move(commands_.front());
+    commands_.pop_front();
+    lock.unlock();
+    command.task();
+    for (auto& callback : command.callbacks) {
+      callback();
+    }
+    lock.lock();
+  }
+}
@@ -0,0 +1,69 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_COMMAND_QUEUE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_COMMAND_QUEUE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs the commands of a player on a worker thread in the order they were
+// posted, so that state changes and seeks, which may block on the pipeline,
+// don't block the thread posting them.
+//
+// A command replaces the pending command of the same kind, if any, as only
+// the latest one matters, e.g. a pause posted while a play is still queued.
+class VideoCommandQueue {
+ public:
+  enum class Kind {
+    // Play and pause.
+    kState,
+    kSeek,
+    kVolume,
+    kPlaybackRate,
+    kLooping,
+    // Restarts posted by the player itself when a looping playback ends.
+    kRestart,
+  };
+
+  using Task = std::function<void()>;
+  // Called once the command has run, or has been replaced by a command which
+  // has run.
+  using Callback = std::function<void()>;
+
+  VideoCommandQueue() = default;
+  // Drops the pending commands and calls their callbacks after the running
+  // command has finished.
+  ~VideoCommandQueue();
+
+  // Prevent copying.
+  VideoCommandQueue(VideoCommandQueue const&) = delete;
+  VideoCommandQueue& operator=(VideoCommandQueue const&) = delete;
+
+  // Posts |task| without waiting for it. |callback| may be empty, and is
+  // called on the worker thread.
+  void Post(Kind kind, Task task, Callback callback);
+
+ private:
+  struct Command {
+    Kind kind;
+    Task task;
+    // The callbacks of the replaced commands come first.
+    std::vector<Callback> callbacks;
+  };
+
+  void Run();
+
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool is_stopped_ = false;
+  std::deque<Command> commands_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_COMMAND_QUEUE_H_
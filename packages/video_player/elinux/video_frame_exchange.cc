@@ -0,0 +1,59 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "video_frame_exchange.h"
+
+VideoFrameExchange::VideoFrameExchange()
+    : pending_(1),
+      back_(0),
+      front_(2),
+      pushed_count_(0),
+      overwritten_count_(0) {
+  for (auto& frame : frames_) {
+    gst_video_info_init(&frame.info);
+  }
+}
+
+VideoFrameExchange::~VideoFrameExchange() { Clear(); }
+
+void VideoFrameExchange::Push(GstBuffer* buffer, const GstVideoInfo& info) {
+  auto& frame = frames_[back_];
+  if (frame.buffer) {
+    gst_buffer_unref(frame.buffer);
+  }
+  frame.buffer = gst_buffer_ref(buffer);
+  frame.info = info;
+  frame.push_time = g_get_monotonic_time();
+
+  const auto previous =
+      pending_.exchange(back_ | kNewFrameFlag, std::memory_order_acq_rel);
+  back_ = previous & kIndexMask;
+  if (previous & kNewFrameFlag) {
+    overwritten_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  pushed_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+const VideoFrameExchange::Frame& VideoFrameExchange::Acquire(bool& is_new) {
+  // Only the producer can change |pending_| after this check, and it always
+  // sets the flag, so the exchanged index is always a new frame.
+  is_new = pending_.load(std::memory_order_acquire) & kNewFrameFlag;
+  if (is_new) {
+    const auto previous = pending_.exchange(front_, std::memory_order_acq_rel);
+    front_ = previous & kIndexMask;
+  }
+  return frames_[front_];
+}
+
+void VideoFrameExchange::Clear() {
+  for (auto& frame : frames_) {
+    if (frame.buffer) {
+      gst_buffer_unref(frame.buffer);
+      frame.buffer = nullptr;
+    }
+  }
+  pending_.store(1, std::memory_order_release);
+  back_ = 0;
+  front_ = 2;
+}
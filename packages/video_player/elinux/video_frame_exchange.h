@@ -0,0 +1,73 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_FRAME_EXCHANGE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_FRAME_EXCHANGE_H_
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include <atomic>
+#include <cstdint>
+
+// Hands decoded frames from a single producer to a single consumer (the raster
+// thread) with a lock-free triple buffer. The producer is the GStreamer
+// streaming thread, or the loop thread of GstVideoPlayer while a cached loop is
+// played, never both: the loop is played only while the pipeline sits at its
+// end, and is stopped and joined before the pipeline is used again.
+// The latest frame always wins: a frame which is replaced before the consumer
+// acquires it is dropped and counted as overwritten.
+class VideoFrameExchange {
+ public:
+  struct Frame {
+    GstBuffer* buffer = nullptr;
+    GstVideoInfo info;
+    // The monotonic time in microseconds when the frame was pushed.
+    gint64 push_time = 0;
+  };
+
+  VideoFrameExchange();
+  ~VideoFrameExchange();
+
+  // Prevent copying.
+  VideoFrameExchange(VideoFrameExchange const&) = delete;
+  VideoFrameExchange& operator=(VideoFrameExchange const&) = delete;
+
+  // Publishes a new frame. Takes a new reference to |buffer|. This must be
+  // called only from the producer thread.
+  void Push(GstBuffer* buffer, const GstVideoInfo& info);
+
+  // Returns the latest published frame, which stays valid until the next call.
+  // |is_new| is set to false if nothing was published since the last call.
+  // The returned frame has no buffer if nothing has been published yet. This
+  // must be called only from the consumer thread.
+  const Frame& Acquire(bool& is_new);
+
+  // Releases all frames. Neither the producer nor the consumer may be running,
+  // and the consumer must not use the frame it acquired anymore.
+  void Clear();
+
+  uint64_t GetPushedCount() const {
+    return pushed_count_.load(std::memory_order_relaxed);
+  }
+  uint64_t GetOverwrittenCount() const {
+    return overwritten_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint8_t kIndexMask = 0x03;
+  static constexpr uint8_t kNewFrameFlag = 0x04;
+
+  Frame frames_[3];
+  // Index of the frame waiting to be acquired, and whether it is new.
+  std::atomic<uint8_t> pending_;
+  // Owned by the producer.
+  uint8_t back_;
+  // Owned by the consumer.
+  uint8_t front_;
+  std::atomic<uint64_t> pushed_count_;
+  std::atomic<uint64_t> overwritten_count_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_FRAME_EXCHANGE_H_
@@ -0,0 +1,104 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "video_loop_cache.h"
+
+#include <iostream>
+
+namespace {
+// How long the last frame is shown if neither its buffer nor the stream tell.
+constexpr GstClockTime kDefaultFrameDuration = GST_SECOND / 30;
+}  // namespace
+
+VideoLoopCache::VideoLoopCache(size_t max_size) : max_size_(max_size) {}
+
+VideoLoopCache::~VideoLoopCache() { ReleaseFrames(); }
+
+void VideoLoopCache::StartRecording() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (state_ == State::kComplete || state_ == State::kOversized) {
+    return;
+  }
+  ReleaseFrames();
+  state_ = State::kRecording;
+}
+
+void VideoLoopCache::AbortRecording() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (state_ != State::kRecording) {
+    return;
+  }
+  ReleaseFrames();
+  state_ = State::kIdle;
+}
+
+void VideoLoopCache::Record(GstBuffer* buffer, const GstVideoInfo& info,
+                            GstClockTime timestamp) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (state_ != State::kRecording) {
+    return;
+  }
+
+  const auto buffer_size = gst_buffer_get_size(buffer);
+  if (size_ + buffer_size > max_size_) {
+    std::cerr << "The clip exceeds the loop cache size of " << max_size_
+              << " bytes" << std::endl;
+    ReleaseFrames();
+    state_ = State::kOversized;
+    return;
+  }
+
+  // The buffer is copied, as the decoder or the converter may recycle it
+  // from a small pool.
+  Frame frame;
+  frame.buffer = gst_buffer_copy_deep(buffer);
+  frame.info = info;
+  frame.timestamp = timestamp;
+  frame.duration = GST_BUFFER_DURATION(buffer);
+  frames_.push_back(frame);
+  size_ += buffer_size;
+}
+
+bool VideoLoopCache::FinishRecording() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (state_ != State::kRecording) {
+    return state_ == State::kComplete;
+  }
+  if (frames_.empty()) {
+    state_ = State::kIdle;
+    return false;
+  }
+
+  // The last frame is shown until the loop restarts.
+  auto& last = frames_.back();
+  if (!GST_CLOCK_TIME_IS_VALID(last.duration)) {
+    if (frames_.size() > 1) {
+      last.duration = last.timestamp - frames_[frames_.size() - 2].timestamp;
+    } else if (GST_VIDEO_INFO_FPS_N(&last.info) > 0) {
+      last.duration = gst_util_uint64_scale_int(
+          GST_SECOND, GST_VIDEO_INFO_FPS_D(&last.info),
+          GST_VIDEO_INFO_FPS_N(&last.info));
+    } else {
+      last.duration = kDefaultFrameDuration;
+    }
+  }
+  state_ = State::kComplete;
+  return true;
+}
+
+void VideoLoopCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReleaseFrames();
+  if (state_ != State::kOversized) {
+    state_ = State::kIdle;
+  }
+}
+
+void VideoLoopCache::ReleaseFrames() {
+  for (auto& frame : frames_) {
+    gst_buffer_unref(frame.buffer);
+  }
+  frames_.clear();
+  size_ = 0;
+}
@@ -0,0 +1,80 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_LOOP_CACHE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_LOOP_CACHE_H_
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Keeps copies of the output frames of one pass of a short clip in memory, so
+// that the following loops are played without demuxing, decoding or
+// converting it again.
+//
+// A recording covers a whole pass from the start of the clip to its end, and
+// is given up for good once its frames exceed the size limit.
+class VideoLoopCache {
+ public:
+  struct Frame {
+    GstBuffer* buffer = nullptr;
+    GstVideoInfo info;
+    // The stream time of the frame, and how long it is shown.
+    GstClockTime timestamp = 0;
+    GstClockTime duration = 0;
+  };
+
+  // |max_size| is the limit in bytes of the cached frames.
+  explicit VideoLoopCache(size_t max_size);
+  ~VideoLoopCache();
+
+  // Prevent copying.
+  VideoLoopCache(VideoLoopCache const&) = delete;
+  VideoLoopCache& operator=(VideoLoopCache const&) = delete;
+
+  // Records the frames passed to Record from now on, dropping the ones of an
+  // unfinished recording. Does nothing once the cache is complete or the clip
+  // turned out to be too large.
+  void StartRecording();
+  // Drops the frames of an unfinished recording, e.g. after a seek which
+  // skipped part of the clip.
+  void AbortRecording();
+  // Copies |buffer| if recording. |timestamp| is its stream time.
+  void Record(GstBuffer* buffer, const GstVideoInfo& info,
+              GstClockTime timestamp);
+  // Ends the recording at the end of the clip. Returns true if the cache is
+  // complete.
+  bool FinishRecording();
+  // Drops all frames, including the ones of a complete cache, which is then
+  // recorded again by the next StartRecording.
+  void Clear();
+
+  bool IsComplete() const { return state_ == State::kComplete; }
+  // The frames of a complete cache, which stay valid until Clear is called.
+  const std::vector<Frame>& GetFrames() const { return frames_; }
+  // Returns the size in bytes of the cached frames.
+  size_t GetSize() const { return size_; }
+
+ private:
+  enum class State {
+    kIdle,
+    kRecording,
+    kComplete,
+    kOversized,
+  };
+
+  void ReleaseFrames();
+
+  const size_t max_size_;
+  std::mutex mutex_;
+  std::atomic<State> state_ = State::kIdle;
+  std::vector<Frame> frames_;
+  std::atomic<size_t> size_ = 0;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_LOOP_CACHE_H_
@@ -0,0 +1,24 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "video_platform_task_queue.h"
+
+#include <utility>
+
+void VideoPlatformTaskQueue::Post(Task task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tasks_.push_back(std::move(task));
+}
+
+void VideoPlatformTaskQueue::RunTasks() {
+  std::deque<Task> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks.swap(tasks_);
+  }
+  // The tasks may post other tasks, which run the next time.
+  for (auto& task : tasks) {
+    task();
+  }
+}
@@ -0,0 +1,42 @@
+// Copyright 2022 Sony Group Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLATFORM_TASK_QUEUE_H_
+#define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLATFORM_TASK_QUEUE_H_
+
+#include <deque>
+#include <functional>
+#include <mutex>
+
+// Hands tasks posted from any thread, such as replies to messages, over to the
+// platform thread.
+//
+// The embedder has no API to post tasks to the platform thread, so the plugin
+// runs the posted tasks whenever it handles a message, which it does on the
+// platform thread.
+class VideoPlatformTaskQueue {
+ public:
+  using Task = std::function<void()>;
+
+  VideoPlatformTaskQueue() = default;
+  // Drops the pending tasks.
+  ~VideoPlatformTaskQueue() = default;
+
+  // Prevent copying.
+  VideoPlatformTaskQueue(VideoPlatformTaskQueue const&) = delete;
+  VideoPlatformTaskQueue& operator=(VideoPlatformTaskQueue const&) = delete;
+
+  // Posts |task| to be run on the platform thread. This may be called from any
+  // thread.
+  void Post(Task task);
+
+  // Runs the posted tasks. This must be called on the platform thread.
+  void RunTasks();
+
+ private:
+  std::mutex mutex_;
+  std::deque<Task> tasks_;
+};
+
+#endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLATFORM_TASK_QUEUE_H_
@@ -14,10 +14,19 @@
 #include <flutter/standard_method_codec.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <unordered_map>
 
+#include "gst_thumbnail_service.h"
+#include "gst_video_memory_budget.h"
 #include "gst_video_player.h"
+#include "gst_video_wall_player.h"
 #include "messages/messages.h"
+#include "video_platform_task_queue.h"
 #include "video_player_stream_handler_impl.h"
 
 namespace {
@@ -44,12 +53,111 @@ constexpr char kVideoPlayerApiChannelSetPlaybackSpeedName[] =
 constexpr char kVideoPlayerApiChannelSeekToName[] =
     "dev.flutter.pigeon.VideoPlayerApi.seekTo";
 
+// The following channels are specific to this plugin.
+constexpr char kVideoPlayerElinuxApiChannelSetPipelinePoolName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.setPipelinePool";
+constexpr char kVideoPlayerElinuxApiChannelGetPipelinePoolStatsName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.getPipelinePoolStats";
+constexpr char kVideoPlayerElinuxApiChannelGetThumbnailsName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.getThumbnails";
+constexpr char kVideoPlayerElinuxApiChannelGetStatsName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.getStats";
+constexpr char kVideoPlayerElinuxApiChannelCreateWallName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.createWall";
+constexpr char kVideoPlayerElinuxApiChannelDisposeWallName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.disposeWall";
+constexpr char kVideoPlayerElinuxApiChannelWallTileName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.wallTile";
+constexpr char kVideoPlayerElinuxApiChannelSetMemoryBudgetName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.setMemoryBudget";
+constexpr char kVideoPlayerElinuxApiChannelGetMemoryUsageName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.getMemoryUsage";
+constexpr char kVideoPlayerElinuxApiChannelSetVisibilityName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.setVisibility";
+constexpr char kVideoPlayerElinuxApiChannelSetTargetFpsName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.setTargetFps";
+constexpr char kVideoPlayerElinuxApiChannelSetDisplayFrameRateName[] =
+    "dev.flutter.pigeon.VideoPlayerElinuxApi.setDisplayFrameRate";
+
 constexpr char kVideoPlayerVideoEventsChannelName[] =
     "flutter.io/videoPlayer/videoEvents";
 
+constexpr char kOutputModeAppSink[] = "appsink";
+
+constexpr char kThumbnailFormatRgba[] = "rgba";
+constexpr char kThumbnailFormatPng[] = "png";
+constexpr char kThumbnailFormatJpeg[] = "jpeg";
+
+constexpr char kWallTileCommandPlay[] = "play";
+constexpr char kWallTileCommandPause[] = "pause";
+constexpr char kWallTileCommandSeekTo[] = "seekTo";
+constexpr char kWallTileCommandSetVolume[] = "setVolume";
+constexpr char kWallTileCommandSetLooping[] = "setLooping";
+
+constexpr char kMemoryLevelNormal[] = "normal";
+constexpr char kMemoryLevelReduced[] = "reduced";
+constexpr char kMemoryLevelSuspended[] = "suspended";
+
+// Textures playing the same uri of these schemes share a decoder.
+constexpr const char* kLiveUriSchemes[] = {"rtsp", "rtsps", "rtspt", "rtspu",
+                                           "rtmp", "rtmps", "rtp",  "udp",
+                                           "srt"};
+
+constexpr char kVideoPlayerErrorCode[] = "VideoError";
+
 constexpr char kEncodableMapkeyResult[] = "result";
 constexpr char kEncodableMapkeyError[] = "error";
 
+bool IsLiveUri(const std::string& uri) {
+  const auto scheme_end = uri.find("://");
+  if (scheme_end == std::string::npos) {
+    return false;
+  }
+  const auto scheme = uri.substr(0, scheme_end);
+  return std::find(std::begin(kLiveUriSchemes), std::end(kLiveUriSchemes),
+                   scheme) != std::end(kLiveUriSchemes);
+}
+
+// Returns the key of the decoder shared by the textures playing |uri| with
+// |options|. Textures created with other options get their own decoder.
+std::string GetSharedPlayerKey(const std::string& uri,
+                               const GstVideoPlayer::Options& options) {
+  std::ostringstream key;
+  key << uri << '\n'
+      << options.zero_copy << static_cast<int>(options.output_mode)
+      << options.yuv_conversion << options.adaptive_resolution
+      << options.validate_position << options.accurate_seek << options.qos
+      << '\n'
+      << options.preroll_timeout << '\n'
+      << options.loop_cache_size;
+  return key.str();
+}
+
+const char* GetMemoryLevelName(GstVideoPlayer::MemoryLevel level) {
+  switch (level) {
+    case GstVideoPlayer::MemoryLevel::kNormal:
+      return kMemoryLevelNormal;
+    case GstVideoPlayer::MemoryLevel::kReduced:
+      return kMemoryLevelReduced;
+    case GstVideoPlayer::MemoryLevel::kSuspended:
+      return kMemoryLevelSuspended;
+  }
+  return "";
+}
+
+// Replies to the message of a command once the command is queued. The
+// embedder has no API to run the reply on the platform thread once the
+// command has run, and the framework may wait for the reply before sending
+// any other message. The commands of a player run in the order they were
+// queued, and their effects are notified by events.
+void ReplyCommandQueued(
+    const flutter::MessageReply<flutter::EncodableValue>& reply) {
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
 class VideoPlayerPlugin : public flutter::Plugin {
  public:
   static void RegisterWithRegistrar(flutter::PluginRegistrar* registrar);
@@ -61,37 +169,79 @@ class VideoPlayerPlugin : public flutter::Plugin {
     // Needs to call 'gst_init' that initializing the GStreamer library before
     // using it.
     GstVideoPlayer::GstLibraryLoad();
+
+    auto* cache_directory = g_build_filename(
+        g_get_user_cache_dir(), "video_player_elinux", "thumbnails", NULL);
+    thumbnail_service_ = std::make_unique<GstThumbnailService>(
+        GstThumbnailService::GetDefaultWorkerCount(), cache_directory);
+    g_free(cache_directory);
   }
   virtual ~VideoPlayerPlugin() {
     for (auto itr = players_.begin(); itr != players_.end(); itr++) {
-      auto texture_id = itr->first;
-      auto* player = itr->second.get();
-      player->event_sink = nullptr;
-      if (player->event_channel) {
-        player->event_channel->SetStreamHandler(nullptr);
-      }
-      player->player = nullptr;
-      player->buffer = nullptr;
-      player->texture = nullptr;
-      texture_registrar_->UnregisterTexture(texture_id);
+      DestroyVideoPlayer(itr->second.get());
     }
     players_.clear();
+    for (auto itr = walls_.begin(); itr != walls_.end(); itr++) {
+      DestroyVideoPlayer(itr->second.get());
+    }
+    walls_.clear();
+    pipeline_pool_.Clear();
+    thumbnail_service_ = nullptr;
 
     GstVideoPlayer::GstLibraryUnload();
   }
 
  private:
+  struct FlutterVideoPlayer;
+
+  // The textures fed by the decoder of a live source.
+  struct SharedPlayer {
+    // The uri and the options of the decoder.
+    std::string key;
+    std::weak_ptr<GstVideoPlayer> player;
+    // The settings of the decoder, which a texture can't change while other
+    // textures share it. Accessed only from the platform thread.
+    double volume = 1.0;
+    double playback_speed = 1.0;
+    bool is_looping = false;
+    // Guards |instances| and their |output_width| and |output_height|, as the
+    // player notifies events from GStreamer threads.
+    std::mutex mutex;
+    std::vector<FlutterVideoPlayer*> instances;
+  };
+
   struct FlutterVideoPlayer {
     int64_t texture_id;
-    std::unique_ptr<GstVideoPlayer> player;
+    // Shared with the other textures of |shared|, if any.
+    std::shared_ptr<GstVideoPlayer> player;
+    std::shared_ptr<SharedPlayer> shared;
+    // The size the texture is drawn at.
+    int32_t output_width = 0;
+    int32_t output_height = 0;
+    bool is_play_requested = false;
+    // Set from the platform thread only.
+    bool is_visible = true;
+    double target_fps = 0;
+    // Set instead of |player| for video walls.
+    std::unique_ptr<GstVideoWallPlayer> wall;
     std::unique_ptr<flutter::TextureVariant> texture;
     std::unique_ptr<FlutterDesktopPixelBuffer> buffer;
+    // The player whose frame |buffer| or |egl_image| points to. It waits for
+    // the frame to be released before being destroyed, so it stays valid even
+    // after |player| is cleared. Accessed only from the raster thread.
+    GstVideoPlayer* drawn_player = nullptr;
 #ifdef USE_EGL_IMAGE_DMABUF
     std::unique_ptr<FlutterDesktopEGLImage> egl_image;
 #endif  // USE_EGL_IMAGE_DMABUF
     std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>>
         event_channel;
     std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> event_sink;
+    // Guards |player|, |wall| and |event_sink|, as the player notifies events
+    // from GStreamer threads.
+    std::mutex mutex;
+    bool is_initialized_event_sent = false;
+    // An error notified before the event channel was listened to.
+    std::string error;
   };
 
   void HandleInitializeMethodCall(
@@ -127,9 +277,83 @@ class VideoPlayerPlugin : public flutter::Plugin {
   void HandlePositionMethodCall(
       const flutter::EncodableValue& message,
       flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetPipelinePoolMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleGetPipelinePoolStatsMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleGetThumbnailsMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleGetStatsMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleCreateWallMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleDisposeWallMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleWallTileMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetMemoryBudgetMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleGetMemoryUsageMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetVisibilityMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetTargetFpsMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+  void HandleSetDisplayFrameRateMethodCall(
+      const flutter::EncodableValue& message,
+      flutter::MessageReply<flutter::EncodableValue> reply);
+
+  // Creates the event channel of |instance|, whose texture must be
+  // registered.
+  void CreateEventChannel(FlutterVideoPlayer* instance);
+  std::unique_ptr<VideoPlayerStreamHandler> CreateStreamHandler(
+      FlutterVideoPlayer* instance);
+  // Creates the stream handler of a decoder shared by the textures of
+  // |shared|.
+  std::unique_ptr<VideoPlayerStreamHandler> CreateSharedStreamHandler(
+      SharedPlayer* shared);
+  void SetOutputSizeHint(FlutterVideoPlayer* instance, int32_t width,
+                         int32_t height);
+  // Applies the visibility and the target frame rate of |instance|, and of
+  // the other textures sharing its decoder, to the decoder.
+  void UpdateThrottling(FlutterVideoPlayer* instance);
+  // Returns true if any texture of |shared| other than |instance| is playing.
+  bool IsPlayRequestedByOthers(FlutterVideoPlayer* instance);
+  // Returns true if |instance| may change the |setting| of its decoder. A
+  // decoder shared with other textures keeps its settings unless |is_changed|
+  // is false, and an error is replied to |reply| otherwise.
+  bool CanChangeDecoder(FlutterVideoPlayer* instance, const char* setting,
+                        bool is_changed,
+                        flutter::MessageReply<flutter::EncodableValue> reply);
+  // Destroys the player of |instance| and unregisters its texture.
+  void DestroyVideoPlayer(FlutterVideoPlayer* instance);
 
-  void SendInitializedEventMessage(int64_t texture_id);
-  void SendPlayCompletedEventMessage(int64_t texture_id);
+  void SendInitializedEventMessage(FlutterVideoPlayer* instance);
+  void SendPlayCompletedEventMessage(FlutterVideoPlayer* instance);
+  void SendBufferingEventMessage(FlutterVideoPlayer* instance,
+                                 bool is_buffering);
+  void SendPlayingStateEventMessage(FlutterVideoPlayer* instance,
+                                    bool is_playing);
+  void SendPlaylistItemChangedEventMessage(FlutterVideoPlayer* instance,
+                                           int32_t index);
+  void SendPlaybackRateChangedEventMessage(FlutterVideoPlayer* instance,
+                                           double rate,
+                                           const std::string& mode);
+  void SendResizedEventMessage(FlutterVideoPlayer* instance, int32_t width,
+                               int32_t height);
+  void SendErrorEventMessage(FlutterVideoPlayer* instance,
+                             const std::string& message);
 
   flutter::EncodableValue WrapError(const std::string& message,
                                     const std::string& code = std::string(),
@@ -140,6 +364,18 @@ class VideoPlayerPlugin : public flutter::Plugin {
   flutter::PluginRegistrar* plugin_registrar_;
   flutter::TextureRegistrar* texture_registrar_;
   std::unordered_map<int64_t, std::unique_ptr<FlutterVideoPlayer>> players_;
+  std::unordered_map<int64_t, std::unique_ptr<FlutterVideoPlayer>> walls_;
+  std::unordered_map<std::string, std::shared_ptr<SharedPlayer>>
+      shared_players_;
+  GstVideoPipelinePool pipeline_pool_;
+  GstVideoMemoryBudget memory_budget_;
+  // The refresh rate of the display, which players don't exceed. Zero means
+  // unknown.
+  int32_t display_frame_rate_ = 0;
+  std::unique_ptr<GstThumbnailService> thumbnail_service_;
+  // Replies completed on other threads, sent when the next message is
+  // handled.
+  VideoPlatformTaskQueue platform_tasks_;
 };
 
 // static
@@ -155,6 +391,7 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandleInitializeMethodCall(message, reply);
         });
   }
@@ -166,6 +403,7 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandleCreateMethodCall(message, reply);
         });
   }
@@ -177,6 +415,7 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandleDisposeMethodCall(message, reply);
         });
   }
@@ -188,6 +427,7 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandlePauseMethodCall(message, reply);
         });
   }
@@ -199,6 +439,7 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandlePlayMethodCall(message, reply);
         });
   }
@@ -210,6 +451,7 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandleSetLoopingMethodCall(message, reply);
         });
   }
@@ -221,6 +463,7 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandleSetVolumeMethodCall(message, reply);
         });
   }
@@ -232,6 +475,7 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandleSetMixWithOthersMethodCall(message, reply);
         });
   }
@@ -243,6 +487,7 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandleSetPlaybackSpeedMethodCall(message, reply);
         });
   }
@@ -254,6 +499,7 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandleSeekToMethodCall(message, reply);
         });
   }
@@ -265,10 +511,163 @@ void VideoPlayerPlugin::RegisterWithRegistrar(
             &flutter::StandardMessageCodec::GetInstance());
     channel->SetMessageHandler(
         [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
           plugin_pointer->HandlePositionMethodCall(message, reply);
         });
   }
 
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(),
+            kVideoPlayerElinuxApiChannelSetPipelinePoolName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleSetPipelinePoolMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(),
+            kVideoPlayerElinuxApiChannelGetPipelinePoolStatsName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleGetPipelinePoolStatsMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(),
+            kVideoPlayerElinuxApiChannelGetThumbnailsName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleGetThumbnailsMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(), kVideoPlayerElinuxApiChannelGetStatsName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleGetStatsMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(), kVideoPlayerElinuxApiChannelCreateWallName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleCreateWallMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(), kVideoPlayerElinuxApiChannelDisposeWallName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleDisposeWallMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(), kVideoPlayerElinuxApiChannelWallTileName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleWallTileMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(),
+            kVideoPlayerElinuxApiChannelSetMemoryBudgetName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleSetMemoryBudgetMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(),
+            kVideoPlayerElinuxApiChannelGetMemoryUsageName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleGetMemoryUsageMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(),
+            kVideoPlayerElinuxApiChannelSetVisibilityName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleSetVisibilityMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(),
+            kVideoPlayerElinuxApiChannelSetTargetFpsName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleSetTargetFpsMethodCall(message, reply);
+        });
+  }
+
+  {
+    auto channel =
+        std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+            registrar->messenger(),
+            kVideoPlayerElinuxApiChannelSetDisplayFrameRateName,
+            &flutter::StandardMessageCodec::GetInstance());
+    channel->SetMessageHandler(
+        [plugin_pointer = plugin.get()](const auto& message, auto reply) {
+          plugin_pointer->platform_tasks_.RunTasks();
+          plugin_pointer->HandleSetDisplayFrameRateMethodCall(message, reply);
+        });
+  }
+
   registrar->AddPlugin(std::move(plugin));
 }
 
@@ -303,70 +702,123 @@ void VideoPlayerPlugin::HandleCreateMethodCall(
           [instance = instance.get()](
               size_t width, size_t height, void* egl_display,
               void* egl_context) -> const FlutterDesktopEGLImage* {
+            // The player may be destroyed on the platform thread meanwhile.
+            std::lock_guard<std::mutex> lock(instance->mutex);
+            if (!instance->player) {
+              return nullptr;
+            }
             instance->egl_image->width = instance->player->GetWidth();
             instance->egl_image->height = instance->player->GetHeight();
             instance->egl_image->egl_image =
                 instance->player->GetEGLImage(egl_display, egl_context);
+            instance->drawn_player = instance->player.get();
             return instance->egl_image.get();
           }));
+  // The image is kept alive until the engine finishes drawing it.
+  instance->egl_image->release_callback = [](void* release_context) {
+    auto* instance = reinterpret_cast<FlutterVideoPlayer*>(release_context);
+    instance->drawn_player->ReleaseFrameBuffer();
+  };
+  instance->egl_image->release_context = instance.get();
 #else
   instance->buffer = std::make_unique<FlutterDesktopPixelBuffer>();
+  // The buffer may point to the mapped decoded frame, so it must be kept
+  // mapped until the engine finishes uploading it.
+  instance->buffer->release_callback = [](void* release_context) {
+    auto* instance = reinterpret_cast<FlutterVideoPlayer*>(release_context);
+    instance->drawn_player->ReleaseFrameBuffer();
+  };
+  instance->buffer->release_context = instance.get();
   instance->texture =
       std::make_unique<flutter::TextureVariant>(flutter::PixelBufferTexture(
-          [instance = instance.get()](
+          [instance = instance.get(), host = this](
               size_t width, size_t height) -> const FlutterDesktopPixelBuffer* {
-            instance->buffer->width = instance->player->GetWidth();
-            instance->buffer->height = instance->player->GetHeight();
-            instance->buffer->buffer = instance->player->GetFrameBuffer();
+            // The player may be destroyed on the platform thread meanwhile.
+            std::lock_guard<std::mutex> lock(instance->mutex);
+            if (!instance->player) {
+              return nullptr;
+            }
+            // |width| and |height| are the size the texture is drawn at.
+            host->SetOutputSizeHint(instance, static_cast<int32_t>(width),
+                                    static_cast<int32_t>(height));
+            int32_t frame_width = 0;
+            int32_t frame_height = 0;
+            instance->buffer->buffer =
+                instance->player->GetFrameBuffer(frame_width, frame_height);
+            instance->drawn_player = instance->player.get();
+            instance->buffer->width = frame_width;
+            instance->buffer->height = frame_height;
             return instance->buffer.get();
           }));
 #endif  // USE_EGL_IMAGE_DMABUF
   const auto texture_id =
       texture_registrar_->RegisterTexture(instance->texture.get());
   instance->texture_id = texture_id;
+  CreateEventChannel(instance.get());
   {
-    auto event_channel =
-        std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
-            plugin_registrar_->messenger(),
-            kVideoPlayerVideoEventsChannelName + std::to_string(texture_id),
-            &flutter::StandardMethodCodec::GetInstance());
-    auto event_channel_handler = std::make_unique<
-        flutter::StreamHandlerFunctions<flutter::EncodableValue>>(
-        [instance = instance.get(), host = this](
-            const flutter::EncodableValue* arguments,
-            std::unique_ptr<flutter::EventSink<flutter::EncodableValue>>&&
-                events)
-            -> std::unique_ptr<
-                flutter::StreamHandlerError<flutter::EncodableValue>> {
-          instance->event_sink = std::move(events);
-          host->SendInitializedEventMessage(instance->texture_id);
-          return nullptr;
-        },
-        [instance = instance.get()](const flutter::EncodableValue* arguments)
-            -> std::unique_ptr<
-                flutter::StreamHandlerError<flutter::EncodableValue>> {
-          instance->event_sink = nullptr;
-          return nullptr;
-        });
-    event_channel->SetStreamHandler(std::move(event_channel_handler));
-    instance->event_channel = std::move(event_channel);
-  }
-  {
-    auto player_handler = std::make_unique<VideoPlayerStreamHandlerImpl>(
-        // OnNotifyInitialized
-        [texture_id, host = this]() {
-          host->SendInitializedEventMessage(texture_id);
-        },
-        // OnNotifyFrameDecoded
-        [texture_id, host = this]() {
-          host->texture_registrar_->MarkTextureFrameAvailable(texture_id);
-        },
-        // OnNotifyCompleted
-        [texture_id, host = this]() {
-          host->SendPlayCompletedEventMessage(texture_id);
-        });
-    instance->player =
-        std::make_unique<GstVideoPlayer>(uri, std::move(player_handler));
+    GstVideoPlayer::Options options;
+    options.zero_copy = meta.GetZeroCopy();
+    if (meta.GetOutputMode() == kOutputModeAppSink) {
+      options.output_mode = GstVideoPlayer::OutputMode::kAppSink;
+    }
+    options.yuv_conversion = meta.GetYuvConversion();
+    options.adaptive_resolution = meta.GetAdaptiveResolution();
+    if (meta.GetPrerollTimeout() >= 0) {
+      options.preroll_timeout = meta.GetPrerollTimeout();
+    }
+    options.validate_position = meta.GetValidatePosition();
+    options.pipeline_pool = &pipeline_pool_;
+    options.playlist = meta.GetPlaylist();
+    options.accurate_seek = meta.GetAccurateSeek();
+    options.qos = meta.GetQos();
+    options.memory_budget = &memory_budget_;
+    options.display_frame_rate = display_frame_rate_;
+    if (meta.GetLoopCacheSize() > 0) {
+      options.loop_cache_size = static_cast<size_t>(meta.GetLoopCacheSize());
+    }
+
+    // Textures showing the same live source with the same options are fed by
+    // one decoder, whose frames they read without copying them.
+    const auto is_shared = meta.GetShareDecoder() &&
+                           meta.GetPlaylist().empty() && IsLiveUri(uri);
+    std::shared_ptr<GstVideoPlayer> player;
+    if (is_shared) {
+      const auto key = GetSharedPlayerKey(uri, options);
+      auto itr = shared_players_.find(key);
+      if (itr != shared_players_.end()) {
+        player = itr->second->player.lock();
+      }
+      if (player) {
+        instance->shared = itr->second;
+      } else {
+        instance->shared = std::make_shared<SharedPlayer>();
+        instance->shared->key = key;
+        shared_players_[key] = instance->shared;
+      }
+      // Added before the player is created so that it doesn't miss any
+      // event.
+      std::lock_guard<std::mutex> lock(instance->shared->mutex);
+      instance->shared->instances.push_back(instance.get());
+    }
+    if (!player) {
+      auto player_handler =
+          instance->shared ? CreateSharedStreamHandler(instance->shared.get())
+                           : CreateStreamHandler(instance.get());
+      // The player prerolls in the background, so this doesn't block.
+      player = std::make_shared<GstVideoPlayer>(
+          uri, std::move(player_handler), options);
+      if (instance->shared) {
+        instance->shared->player = player;
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(instance->mutex);
+      instance->player = std::move(player);
+    }
+    if (instance->shared) {
+      // The decoder may have been throttled by the other textures.
+      UpdateThrottling(instance.get());
+    }
     players_[texture_id] = std::move(instance);
   }
 
@@ -386,14 +838,8 @@ void VideoPlayerPlugin::HandleDisposeMethodCall(
   flutter::EncodableMap result;
 
   if (players_.find(texture_id) != players_.end()) {
-    auto* player = players_[texture_id].get();
-    player->event_sink = nullptr;
-    player->event_channel->SetStreamHandler(nullptr);
-    player->player = nullptr;
-    player->buffer = nullptr;
-    player->texture = nullptr;
+    DestroyVideoPlayer(players_[texture_id].get());
     players_.erase(texture_id);
-    texture_registrar_->UnregisterTexture(texture_id);
 
     result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
                    flutter::EncodableValue());
@@ -414,7 +860,12 @@ void VideoPlayerPlugin::HandlePauseMethodCall(
   flutter::EncodableMap result;
 
   if (players_.find(texture_id) != players_.end()) {
-    players_[texture_id]->player->Pause();
+    auto* instance = players_[texture_id].get();
+    instance->is_play_requested = false;
+    // A shared decoder keeps playing while another texture plays it.
+    if (!IsPlayRequestedByOthers(instance)) {
+      instance->player->PostPause(nullptr);
+    }
     result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
                    flutter::EncodableValue());
   } else {
@@ -433,17 +884,19 @@ void VideoPlayerPlugin::HandlePlayMethodCall(
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
 
-  if (players_.find(texture_id) != players_.end()) {
-    players_[texture_id]->player->Play();
-    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
-                   flutter::EncodableValue());
-  } else {
+  if (players_.find(texture_id) == players_.end()) {
     auto error_message = "Couldn't find the player with texture id: " +
                          std::to_string(texture_id);
     result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
                    flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
   }
-  reply(flutter::EncodableValue(result));
+
+  auto* instance = players_[texture_id].get();
+  instance->is_play_requested = true;
+  instance->player->PostPlay(nullptr);
+  ReplyCommandQueued(reply);
 }
 
 void VideoPlayerPlugin::HandleSetLoopingMethodCall(
@@ -453,17 +906,26 @@ void VideoPlayerPlugin::HandleSetLoopingMethodCall(
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
 
-  if (players_.find(texture_id) != players_.end()) {
-    players_[texture_id]->player->SetAutoRepeat(parameter.GetIsLooping());
-    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
-                   flutter::EncodableValue());
-  } else {
+  if (players_.find(texture_id) == players_.end()) {
     auto error_message = "Couldn't find the player with texture id: " +
                          std::to_string(texture_id);
     result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
                    flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
   }
-  reply(flutter::EncodableValue(result));
+
+  auto* instance = players_[texture_id].get();
+  const auto is_looping = parameter.GetIsLooping();
+  if (instance->shared) {
+    if (!CanChangeDecoder(instance, "looping",
+                          is_looping != instance->shared->is_looping, reply)) {
+      return;
+    }
+    instance->shared->is_looping = is_looping;
+  }
+  instance->player->PostAutoRepeat(is_looping, nullptr);
+  ReplyCommandQueued(reply);
 }
 
 void VideoPlayerPlugin::HandleSetVolumeMethodCall(
@@ -473,17 +935,26 @@ void VideoPlayerPlugin::HandleSetVolumeMethodCall(
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
 
-  if (players_.find(texture_id) != players_.end()) {
-    players_[texture_id]->player->SetVolume(parameter.GetVolume());
-    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
-                   flutter::EncodableValue());
-  } else {
+  if (players_.find(texture_id) == players_.end()) {
     auto error_message = "Couldn't find the player with texture id: " +
                          std::to_string(texture_id);
     result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
                    flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
   }
-  reply(flutter::EncodableValue(result));
+
+  auto* instance = players_[texture_id].get();
+  const auto volume = parameter.GetVolume();
+  if (instance->shared) {
+    if (!CanChangeDecoder(instance, "volume",
+                          volume != instance->shared->volume, reply)) {
+      return;
+    }
+    instance->shared->volume = volume;
+  }
+  instance->player->PostVolume(volume, nullptr);
+  ReplyCommandQueued(reply);
 }
 
 void VideoPlayerPlugin::HandleSetMixWithOthersMethodCall(
@@ -534,8 +1005,430 @@ void VideoPlayerPlugin::HandleSetPlaybackSpeedMethodCall(
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
 
+  if (players_.find(texture_id) == players_.end()) {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  auto* instance = players_[texture_id].get();
+  const auto speed = parameter.GetSpeed();
+  if (instance->shared) {
+    if (!CanChangeDecoder(instance, "playback speed",
+                          speed != instance->shared->playback_speed, reply)) {
+      return;
+    }
+    instance->shared->playback_speed = speed;
+  }
+  instance->player->PostPlaybackRate(speed, nullptr);
+  ReplyCommandQueued(reply);
+}
+
+void VideoPlayerPlugin::HandleSeekToMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = PositionMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) == players_.end()) {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  auto* instance = players_[texture_id].get();
+  if (instance->shared &&
+      !CanChangeDecoder(instance, "position", true, reply)) {
+    return;
+  }
+  instance->player->PostSeek(parameter.GetPosition(), nullptr);
+  ReplyCommandQueued(reply);
+}
+
+void VideoPlayerPlugin::HandleSetPipelinePoolMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = PipelinePoolMessage::FromMap(message);
+  flutter::EncodableMap result;
+
+  if (parameter.GetCapacity() < 0 || parameter.GetPrewarmCount() < 0) {
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(
+                       "The pipeline pool sizes must not be negative")));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  pipeline_pool_.SetCapacity(parameter.GetCapacity());
+  if (parameter.GetPrewarmCount() > 0) {
+    GstVideoPlayer::Options options;
+    if (parameter.GetOutputMode() == kOutputModeAppSink) {
+      options.output_mode = GstVideoPlayer::OutputMode::kAppSink;
+    }
+    options.yuv_conversion = parameter.GetYuvConversion();
+    options.adaptive_resolution = parameter.GetAdaptiveResolution();
+    options.pipeline_pool = &pipeline_pool_;
+    GstVideoPlayer::PrewarmPipelines(options, parameter.GetPrewarmCount());
+  }
+
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleGetPipelinePoolStatsMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  const auto stats = pipeline_pool_.GetStats();
+  PipelinePoolStatsMessage send_message;
+  send_message.SetCapacity(stats.capacity);
+  send_message.SetIdleCount(stats.idle_count);
+  send_message.SetHitCount(stats.hit_count);
+  send_message.SetMissCount(stats.miss_count);
+
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 send_message.ToMap());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleGetThumbnailsMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  std::vector<GstThumbnailService::Request> requests;
+  if (std::holds_alternative<flutter::EncodableMap>(message)) {
+    auto map = std::get<flutter::EncodableMap>(message);
+    auto& list = map[flutter::EncodableValue("requests")];
+    if (std::holds_alternative<flutter::EncodableList>(list)) {
+      for (const auto& item : std::get<flutter::EncodableList>(list)) {
+        auto parameter = ThumbnailRequestMessage::FromMap(item);
+        GstThumbnailService::Request request;
+        request.uri = parameter.GetUri();
+        request.position = parameter.GetPosition();
+        request.max_width = parameter.GetMaxWidth();
+        request.max_height = parameter.GetMaxHeight();
+        const auto format = parameter.GetFormat();
+        if (format == kThumbnailFormatRgba) {
+          request.format = GstThumbnailService::Format::kRgba;
+        } else if (format == kThumbnailFormatJpeg) {
+          request.format = GstThumbnailService::Format::kJpeg;
+        } else if (format.empty() || format == kThumbnailFormatPng) {
+          request.format = GstThumbnailService::Format::kPng;
+        } else {
+          flutter::EncodableMap result;
+          result.emplace(
+              flutter::EncodableValue(kEncodableMapkeyError),
+              flutter::EncodableValue(
+                  WrapError("Unsupported thumbnail format: " + format)));
+          reply(flutter::EncodableValue(result));
+          return;
+        }
+        requests.push_back(std::move(request));
+      }
+    }
+  }
+
+  // The reply is queued once all thumbnails are extracted, and sent on the
+  // platform thread when the plugin handles a message next.
+  thumbnail_service_->Extract(
+      std::move(requests),
+      [host = this,
+       reply](std::vector<GstThumbnailService::Result> thumbnails) {
+        flutter::EncodableList list;
+        for (auto& thumbnail : thumbnails) {
+          ThumbnailResultMessage send_message;
+          send_message.SetWidth(thumbnail.width);
+          send_message.SetHeight(thumbnail.height);
+          send_message.SetData(std::move(thumbnail.data));
+          send_message.SetError(thumbnail.error);
+          list.push_back(send_message.ToMap());
+        }
+
+        flutter::EncodableMap result;
+        result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                       flutter::EncodableValue(list));
+        host->platform_tasks_.Post([reply, result = std::move(result)]() {
+          reply(flutter::EncodableValue(result));
+        });
+      });
+  // An empty list of requests is replied to right away, so it can be used to
+  // collect the replies of the previous batches.
+  platform_tasks_.RunTasks();
+}
+
+void VideoPlayerPlugin::HandleGetStatsMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = TextureMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (players_.find(texture_id) != players_.end()) {
+    const auto stats = players_[texture_id]->player->GetStats();
+    PlayerStatsMessage send_message;
+    send_message.SetTextureId(texture_id);
+    send_message.SetDecodedFrames(stats.decoded_frame_count);
+    send_message.SetRenderedFrames(stats.rendered_frame_count);
+    send_message.SetDroppedFrames(stats.dropped_frame_count);
+    send_message.SetOverwrittenFrames(stats.overwritten_frame_count);
+    send_message.SetQosDroppedFrames(stats.qos_dropped_frame_count);
+    send_message.SetQosEvents(stats.qos_event_count);
+    send_message.SetDecoderDroppedFrames(stats.decoder_dropped_frame_count);
+    send_message.SetThrottledFrames(stats.throttled_frame_count);
+    send_message.SetDecimatedFrames(stats.decimated_frame_count);
+    send_message.SetDecimationRatio(stats.decimation_ratio);
+    send_message.SetLoopCachedFrames(stats.loop_cached_frame_count);
+    send_message.SetLoopCacheSize(stats.loop_cache_size);
+    send_message.SetCopiedFrames(stats.copied_frame_count);
+    send_message.SetCopyTime(stats.copy_time);
+    send_message.SetLatencyBucketBounds(
+        std::vector<int64_t>(std::begin(GstVideoPlayer::kLatencyBucketBounds),
+                             std::end(GstVideoPlayer::kLatencyBucketBounds)));
+    send_message.SetLatencyHistogram(std::vector<int64_t>(
+        stats.latency_histogram.begin(), stats.latency_histogram.end()));
+    send_message.SetBitrate(stats.bitrate);
+    send_message.SetBufferPercent(stats.buffer_percent);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   send_message.ToMap());
+  } else {
+    auto error_message = "Couldn't find the player with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+  }
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleCreateWallMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = CreateWallMessage::FromMap(message);
+  const auto uris = parameter.GetUris();
+  if (uris.empty()) {
+    flutter::EncodableMap result;
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError("No uris of the wall")));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  auto instance = std::make_unique<FlutterVideoPlayer>();
+  // The tiles are composed in memory, so the wall is a pixel buffer texture
+  // even with EGLImage.
+  instance->buffer = std::make_unique<FlutterDesktopPixelBuffer>();
+  instance->texture =
+      std::make_unique<flutter::TextureVariant>(flutter::PixelBufferTexture(
+          [instance = instance.get()](
+              size_t width, size_t height) -> const FlutterDesktopPixelBuffer* {
+            // Tiles may decode frames before the wall is stored, and the wall
+            // may be destroyed on the platform thread meanwhile.
+            std::lock_guard<std::mutex> lock(instance->mutex);
+            if (!instance->wall) {
+              return nullptr;
+            }
+            int32_t frame_width = 0;
+            int32_t frame_height = 0;
+            instance->buffer->buffer =
+                instance->wall->GetFrameBuffer(frame_width, frame_height);
+            instance->buffer->width = frame_width;
+            instance->buffer->height = frame_height;
+            return instance->buffer.get();
+          }));
+  const auto texture_id =
+      texture_registrar_->RegisterTexture(instance->texture.get());
+  instance->texture_id = texture_id;
+  CreateEventChannel(instance.get());
+  {
+    GstVideoWallPlayer::Options options;
+    options.width = static_cast<int32_t>(parameter.GetWidth());
+    options.height = static_cast<int32_t>(parameter.GetHeight());
+    options.columns = static_cast<int32_t>(parameter.GetColumns());
+    options.player_options.pipeline_pool = &pipeline_pool_;
+    options.player_options.memory_budget = &memory_budget_;
+    options.player_options.display_frame_rate = display_frame_rate_;
+    auto wall = std::make_unique<GstVideoWallPlayer>(
+        uris, CreateStreamHandler(instance.get()), options);
+    {
+      std::lock_guard<std::mutex> lock(instance->mutex);
+      instance->wall = std::move(wall);
+    }
+    walls_[texture_id] = std::move(instance);
+  }
+
+  flutter::EncodableMap value;
+  TextureMessage result;
+  result.SetTextureId(texture_id);
+  value.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                result.ToMap());
+  reply(flutter::EncodableValue(value));
+}
+
+void VideoPlayerPlugin::HandleDisposeWallMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = TextureMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (walls_.find(texture_id) != walls_.end()) {
+    DestroyVideoPlayer(walls_[texture_id].get());
+    walls_.erase(texture_id);
+
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                   flutter::EncodableValue());
+  } else {
+    auto error_message = "Couldn't find the wall with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+  }
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleWallTileMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = WallTileMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
+  if (walls_.find(texture_id) == walls_.end()) {
+    auto error_message = "Couldn't find the wall with texture id: " +
+                         std::to_string(texture_id);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  // A negative tile applies the command to all tiles.
+  auto* wall = walls_[texture_id]->wall.get();
+  std::vector<GstVideoPlayer*> tiles;
+  const auto tile = parameter.GetTile();
+  if (tile < 0) {
+    for (size_t i = 0; i < wall->GetTileCount(); i++) {
+      tiles.push_back(wall->GetTile(i));
+    }
+  } else if (auto* player = wall->GetTile(static_cast<size_t>(tile))) {
+    tiles.push_back(player);
+  } else {
+    auto error_message = "Couldn't find the tile: " + std::to_string(tile);
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(WrapError(error_message)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  const auto command = parameter.GetCommand();
+  if (command != kWallTileCommandPlay && command != kWallTileCommandPause &&
+      command != kWallTileCommandSeekTo &&
+      command != kWallTileCommandSetVolume &&
+      command != kWallTileCommandSetLooping) {
+    result.emplace(
+        flutter::EncodableValue(kEncodableMapkeyError),
+        flutter::EncodableValue(WrapError("Unknown command: " + command)));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  for (auto* player : tiles) {
+    if (command == kWallTileCommandPlay) {
+      player->PostPlay(nullptr);
+    } else if (command == kWallTileCommandPause) {
+      player->PostPause(nullptr);
+    } else if (command == kWallTileCommandSeekTo) {
+      player->PostSeek(parameter.GetPosition(), nullptr);
+    } else if (command == kWallTileCommandSetLooping) {
+      player->PostAutoRepeat(parameter.GetIsLooping(), nullptr);
+    } else {
+      player->PostVolume(parameter.GetVolume(), nullptr);
+    }
+  }
+  ReplyCommandQueued(reply);
+}
+
+void VideoPlayerPlugin::HandleSetMemoryBudgetMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = MemoryBudgetMessage::FromMap(message);
+  flutter::EncodableMap result;
+
+  if (parameter.GetBudget() < 0) {
+    result.emplace(
+        flutter::EncodableValue(kEncodableMapkeyError),
+        flutter::EncodableValue(WrapError("The budget must not be negative")));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  memory_budget_.SetBudget(static_cast<size_t>(parameter.GetBudget()));
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleGetMemoryUsageMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  // Reported per decoder, as the budget counts them: a decoder shared by
+  // several textures once, and each tile of a wall.
+  std::vector<MemoryUsageMessage::Player> players;
+  std::unordered_map<const GstVideoPlayer*, size_t> indices;
+  auto add_player = [&players, &indices](const GstVideoPlayer* decoder,
+                                         int64_t texture_id, int64_t tile) {
+    auto itr = indices.find(decoder);
+    if (itr != indices.end()) {
+      players[itr->second].texture_ids.push_back(texture_id);
+      return;
+    }
+    indices[decoder] = players.size();
+    MemoryUsageMessage::Player player;
+    player.texture_id = texture_id;
+    player.texture_ids.push_back(texture_id);
+    player.tile = tile;
+    player.usage = decoder->GetMemoryUsage();
+    player.level = GetMemoryLevelName(decoder->GetMemoryLevel());
+    players.push_back(player);
+  };
+  for (const auto& [texture_id, instance] : players_) {
+    add_player(instance->player.get(), texture_id, -1);
+  }
+  for (const auto& [texture_id, instance] : walls_) {
+    for (size_t i = 0; i < instance->wall->GetTileCount(); i++) {
+      add_player(instance->wall->GetTile(i), texture_id,
+                 static_cast<int64_t>(i));
+    }
+  }
+
+  MemoryUsageMessage send_message;
+  send_message.SetBudget(memory_budget_.GetBudget());
+  send_message.SetUsage(memory_budget_.GetUsage());
+  send_message.SetPlayers(players);
+
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 send_message.ToMap());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::HandleSetVisibilityMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = VisibilityMessage::FromMap(message);
+  const auto texture_id = parameter.GetTextureId();
+  flutter::EncodableMap result;
+
   if (players_.find(texture_id) != players_.end()) {
-    players_[texture_id]->player->SetPlaybackRate(parameter.GetSpeed());
+    auto* instance = players_[texture_id].get();
+    instance->is_visible = parameter.GetIsVisible();
+    UpdateThrottling(instance);
     result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
                    flutter::EncodableValue());
   } else {
@@ -547,15 +1440,17 @@ void VideoPlayerPlugin::HandleSetPlaybackSpeedMethodCall(
   reply(flutter::EncodableValue(result));
 }
 
-void VideoPlayerPlugin::HandleSeekToMethodCall(
+void VideoPlayerPlugin::HandleSetTargetFpsMethodCall(
     const flutter::EncodableValue& message,
     flutter::MessageReply<flutter::EncodableValue> reply) {
-  auto parameter = PositionMessage::FromMap(message);
+  auto parameter = TargetFpsMessage::FromMap(message);
   const auto texture_id = parameter.GetTextureId();
   flutter::EncodableMap result;
 
   if (players_.find(texture_id) != players_.end()) {
-    players_[texture_id]->player->SetSeek(parameter.GetPosition());
+    auto* instance = players_[texture_id].get();
+    instance->target_fps = std::max(parameter.GetFps(), 0.0);
+    UpdateThrottling(instance);
     result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
                    flutter::EncodableValue());
   } else {
@@ -567,15 +1462,330 @@ void VideoPlayerPlugin::HandleSeekToMethodCall(
   reply(flutter::EncodableValue(result));
 }
 
-void VideoPlayerPlugin::SendInitializedEventMessage(int64_t texture_id) {
-  if (players_.find(texture_id) == players_.end() ||
-      !players_[texture_id]->event_sink) {
+void VideoPlayerPlugin::HandleSetDisplayFrameRateMethodCall(
+    const flutter::EncodableValue& message,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  auto parameter = DisplayFrameRateMessage::FromMap(message);
+  flutter::EncodableMap result;
+
+  if (parameter.GetFrameRate() < 0) {
+    result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                   flutter::EncodableValue(
+                       WrapError("The frame rate must not be negative")));
+    reply(flutter::EncodableValue(result));
+    return;
+  }
+
+  // Players created with a frame rate follow its changes, and the later ones
+  // are created with it.
+  display_frame_rate_ = static_cast<int32_t>(
+      std::min<int64_t>(parameter.GetFrameRate(), G_MAXINT32));
+  for (auto& [texture_id, instance] : players_) {
+    instance->player->SetDisplayFrameRate(display_frame_rate_);
+  }
+  for (auto& [texture_id, instance] : walls_) {
+    for (size_t i = 0; i < instance->wall->GetTileCount(); i++) {
+      instance->wall->GetTile(i)->SetDisplayFrameRate(display_frame_rate_);
+    }
+  }
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyResult),
+                 flutter::EncodableValue());
+  reply(flutter::EncodableValue(result));
+}
+
+void VideoPlayerPlugin::CreateEventChannel(FlutterVideoPlayer* instance) {
+  auto event_channel =
+      std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
+          plugin_registrar_->messenger(),
+          kVideoPlayerVideoEventsChannelName +
+              std::to_string(instance->texture_id),
+          &flutter::StandardMethodCodec::GetInstance());
+  auto event_channel_handler = std::make_unique<
+      flutter::StreamHandlerFunctions<flutter::EncodableValue>>(
+      [instance, host = this](
+          const flutter::EncodableValue* arguments,
+          std::unique_ptr<flutter::EventSink<flutter::EncodableValue>>&& events)
+          -> std::unique_ptr<
+              flutter::StreamHandlerError<flutter::EncodableValue>> {
+        {
+          std::lock_guard<std::mutex> lock(instance->mutex);
+          instance->event_sink = std::move(events);
+          if (!instance->error.empty()) {
+            instance->event_sink->Error(kVideoPlayerErrorCode, instance->error);
+            return nullptr;
+          }
+        }
+        // The player may have been prerolled before this was listened to.
+        host->SendInitializedEventMessage(instance);
+        return nullptr;
+      },
+      [instance](const flutter::EncodableValue* arguments)
+          -> std::unique_ptr<
+              flutter::StreamHandlerError<flutter::EncodableValue>> {
+        std::lock_guard<std::mutex> lock(instance->mutex);
+        instance->event_sink = nullptr;
+        return nullptr;
+      });
+  event_channel->SetStreamHandler(std::move(event_channel_handler));
+  instance->event_channel = std::move(event_channel);
+}
+
+std::unique_ptr<VideoPlayerStreamHandler>
+VideoPlayerPlugin::CreateStreamHandler(FlutterVideoPlayer* instance) {
+  return std::make_unique<VideoPlayerStreamHandlerImpl>(
+      // OnNotifyInitialized
+      [instance, host = this]() {
+        host->SendInitializedEventMessage(instance);
+      },
+      // OnNotifyFrameDecoded
+      [texture_id = instance->texture_id, host = this]() {
+        host->texture_registrar_->MarkTextureFrameAvailable(texture_id);
+      },
+      // OnNotifyCompleted
+      [instance, host = this]() {
+        host->SendPlayCompletedEventMessage(instance);
+      },
+      // OnNotifyBufferingStateChanged
+      [instance, host = this](bool is_buffering) {
+        host->SendBufferingEventMessage(instance, is_buffering);
+      },
+      // OnNotifyPlayingStateChanged
+      [instance, host = this](bool is_playing) {
+        host->SendPlayingStateEventMessage(instance, is_playing);
+      },
+      // OnNotifyPlaylistItemChanged
+      [instance, host = this](int32_t index) {
+        host->SendPlaylistItemChangedEventMessage(instance, index);
+      },
+      // OnNotifyPlaybackRateChanged
+      [instance, host = this](double rate, const std::string& mode) {
+        host->SendPlaybackRateChangedEventMessage(instance, rate, mode);
+      },
+      // OnNotifyResized
+      [instance, host = this](int32_t width, int32_t height) {
+        host->SendResizedEventMessage(instance, width, height);
+      },
+      // OnNotifyError
+      [instance, host = this](const std::string& message) {
+        host->SendErrorEventMessage(instance, message);
+      });
+}
+
+std::unique_ptr<VideoPlayerStreamHandler>
+VideoPlayerPlugin::CreateSharedStreamHandler(SharedPlayer* shared) {
+  // Forwards the events to all textures of |shared|.
+  auto for_each_instance =
+      [shared](const std::function<void(FlutterVideoPlayer*)>& callback) {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        for (auto* instance : shared->instances) {
+          callback(instance);
+        }
+      };
+  return std::make_unique<VideoPlayerStreamHandlerImpl>(
+      // OnNotifyInitialized
+      [for_each_instance, host = this]() {
+        for_each_instance([host](FlutterVideoPlayer* instance) {
+          host->SendInitializedEventMessage(instance);
+        });
+      },
+      // OnNotifyFrameDecoded
+      [for_each_instance, host = this]() {
+        for_each_instance([host](FlutterVideoPlayer* instance) {
+          host->texture_registrar_->MarkTextureFrameAvailable(
+              instance->texture_id);
+        });
+      },
+      // OnNotifyCompleted
+      [for_each_instance, host = this]() {
+        for_each_instance([host](FlutterVideoPlayer* instance) {
+          host->SendPlayCompletedEventMessage(instance);
+        });
+      },
+      // OnNotifyBufferingStateChanged
+      [for_each_instance, host = this](bool is_buffering) {
+        for_each_instance([host, is_buffering](FlutterVideoPlayer* instance) {
+          host->SendBufferingEventMessage(instance, is_buffering);
+        });
+      },
+      // OnNotifyPlayingStateChanged
+      [for_each_instance, host = this](bool is_playing) {
+        for_each_instance([host, is_playing](FlutterVideoPlayer* instance) {
+          host->SendPlayingStateEventMessage(instance, is_playing);
+        });
+      },
+      // OnNotifyPlaylistItemChanged
+      [for_each_instance, host = this](int32_t index) {
+        for_each_instance([host, index](FlutterVideoPlayer* instance) {
+          host->SendPlaylistItemChangedEventMessage(instance, index);
+        });
+      },
+      // OnNotifyPlaybackRateChanged
+      [for_each_instance, host = this](double rate, const std::string& mode) {
+        for_each_instance([host, rate, &mode](FlutterVideoPlayer* instance) {
+          host->SendPlaybackRateChangedEventMessage(instance, rate, mode);
+        });
+      },
+      // OnNotifyResized
+      [for_each_instance, host = this](int32_t width, int32_t height) {
+        for_each_instance([host, width, height](FlutterVideoPlayer* instance) {
+          host->SendResizedEventMessage(instance, width, height);
+        });
+      },
+      // OnNotifyError
+      [for_each_instance, host = this](const std::string& message) {
+        for_each_instance([host, &message](FlutterVideoPlayer* instance) {
+          host->SendErrorEventMessage(instance, message);
+        });
+      });
+}
+
+void VideoPlayerPlugin::SetOutputSizeHint(FlutterVideoPlayer* instance,
+                                          int32_t width, int32_t height) {
+  // A shared decoder is scaled for the largest of its textures.
+  if (instance->shared) {
+    std::lock_guard<std::mutex> lock(instance->shared->mutex);
+    instance->output_width = width;
+    instance->output_height = height;
+    for (const auto* other : instance->shared->instances) {
+      width = std::max(width, other->output_width);
+      height = std::max(height, other->output_height);
+    }
+  }
+  instance->player->SetOutputSizeHint(width, height);
+}
+
+void VideoPlayerPlugin::UpdateThrottling(FlutterVideoPlayer* instance) {
+  // A shared decoder is visible while any of its textures is, and runs at the
+  // highest target frame rate of them, where zero is unlimited.
+  auto is_visible = instance->is_visible;
+  auto target_fps = instance->target_fps;
+  if (instance->shared) {
+    std::lock_guard<std::mutex> lock(instance->shared->mutex);
+    for (const auto* other : instance->shared->instances) {
+      is_visible |= other->is_visible;
+      target_fps = (target_fps <= 0 || other->target_fps <= 0)
+                       ? 0
+                       : std::max(target_fps, other->target_fps);
+    }
+  }
+  instance->player->SetVisible(is_visible);
+  instance->player->SetTargetFrameRate(target_fps);
+}
+
+bool VideoPlayerPlugin::IsPlayRequestedByOthers(FlutterVideoPlayer* instance) {
+  if (!instance->shared) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(instance->shared->mutex);
+  for (const auto* other : instance->shared->instances) {
+    if (other != instance && other->is_play_requested) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool VideoPlayerPlugin::CanChangeDecoder(
+    FlutterVideoPlayer* instance, const char* setting, bool is_changed,
+    flutter::MessageReply<flutter::EncodableValue> reply) {
+  if (!instance->shared || !is_changed) {
+    return true;
+  }
+  {
+    std::lock_guard<std::mutex> lock(instance->shared->mutex);
+    if (instance->shared->instances.size() <= 1) {
+      return true;
+    }
+  }
+
+  auto error_message = std::string("Couldn't change the ") + setting +
+                       " of the decoder shared by texture id: " +
+                       std::to_string(instance->texture_id);
+  flutter::EncodableMap result;
+  result.emplace(flutter::EncodableValue(kEncodableMapkeyError),
+                 flutter::EncodableValue(WrapError(error_message)));
+  reply(flutter::EncodableValue(result));
+  return false;
+}
+
+void VideoPlayerPlugin::DestroyVideoPlayer(FlutterVideoPlayer* instance) {
+  // The texture is unregistered first so that it stops fetching frames. The
+  // player then waits for the frame being drawn to be released, and the buffer
+  // is freed only after that.
+  texture_registrar_->UnregisterTexture(instance->texture_id);
+  // Taken with the lock held, as the texture callbacks use them, but destroyed
+  // without it, as that waits for the pipeline.
+  std::shared_ptr<GstVideoPlayer> player;
+  std::unique_ptr<GstVideoWallPlayer> wall;
+  {
+    std::lock_guard<std::mutex> lock(instance->mutex);
+    instance->event_sink = nullptr;
+    player = std::move(instance->player);
+    wall = std::move(instance->wall);
+  }
+  if (instance->event_channel) {
+    instance->event_channel->SetStreamHandler(nullptr);
+  }
+  if (instance->shared) {
+    // The decoder is destroyed with its last texture, and is paused if none
+    // of the remaining textures plays it.
+    if (instance->is_play_requested && !IsPlayRequestedByOthers(instance)) {
+      player->PostPause(nullptr);
+    }
+    auto shared = std::move(instance->shared);
+    FlutterVideoPlayer* remaining = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(shared->mutex);
+      auto& instances = shared->instances;
+      instances.erase(std::remove(instances.begin(), instances.end(), instance),
+                      instances.end());
+      if (!instances.empty()) {
+        remaining = instances.front();
+      }
+    }
+    const auto is_last = remaining == nullptr;
+    if (remaining) {
+      // The throttling no longer depends on this texture.
+      UpdateThrottling(remaining);
+    }
+    // The decoder must be destroyed before |shared|, which its stream handler
+    // refers to.
+    player = nullptr;
+    auto itr = shared_players_.find(shared->key);
+    if (is_last && itr != shared_players_.end() && itr->second == shared) {
+      shared_players_.erase(itr);
+    }
+  }
+  player = nullptr;
+  wall = nullptr;
+  instance->buffer = nullptr;
+#ifdef USE_EGL_IMAGE_DMABUF
+  instance->egl_image = nullptr;
+#endif  // USE_EGL_IMAGE_DMABUF
+  instance->texture = nullptr;
+}
+
+void VideoPlayerPlugin::SendInitializedEventMessage(
+    FlutterVideoPlayer* instance) {
+  std::lock_guard<std::mutex> lock(instance->mutex);
+  if (!instance->event_sink || instance->is_initialized_event_sent) {
     return;
   }
 
-  auto duration = players_[texture_id]->player->GetDuration();
-  auto width = players_[texture_id]->player->GetWidth();
-  auto height = players_[texture_id]->player->GetHeight();
+  int64_t duration;
+  int32_t width;
+  int32_t height;
+  if (instance->player && instance->player->IsInitialized()) {
+    duration = instance->player->GetDuration();
+    width = instance->player->GetWidth();
+    height = instance->player->GetHeight();
+  } else if (instance->wall && instance->wall->IsInitialized()) {
+    duration = instance->wall->GetDuration();
+    width = instance->wall->GetWidth();
+    height = instance->wall->GetHeight();
+  } else {
+    return;
+  }
   flutter::EncodableMap encodables = {
       {flutter::EncodableValue("event"),
        flutter::EncodableValue("initialized")},
@@ -583,19 +1793,110 @@ void VideoPlayerPlugin::SendInitializedEventMessage(int64_t texture_id) {
       {flutter::EncodableValue("width"), flutter::EncodableValue(width)},
       {flutter::EncodableValue("height"), flutter::EncodableValue(height)}};
   flutter::EncodableValue event(encodables);
-  players_[texture_id]->event_sink->Success(event);
+  instance->event_sink->Success(event);
+  instance->is_initialized_event_sent = true;
 }
 
-void VideoPlayerPlugin::SendPlayCompletedEventMessage(int64_t texture_id) {
-  if (players_.find(texture_id) == players_.end() ||
-      !players_[texture_id]->event_sink) {
+void VideoPlayerPlugin::SendPlayCompletedEventMessage(
+    FlutterVideoPlayer* instance) {
+  std::lock_guard<std::mutex> lock(instance->mutex);
+  if (!instance->event_sink) {
     return;
   }
 
   flutter::EncodableMap encodables = {
       {flutter::EncodableValue("event"), flutter::EncodableValue("completed")}};
   flutter::EncodableValue event(encodables);
-  players_[texture_id]->event_sink->Success(event);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendBufferingEventMessage(
+    FlutterVideoPlayer* instance, bool is_buffering) {
+  std::lock_guard<std::mutex> lock(instance->mutex);
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue(is_buffering ? "bufferingStart"
+                                            : "bufferingEnd")}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendPlayingStateEventMessage(
+    FlutterVideoPlayer* instance, bool is_playing) {
+  std::lock_guard<std::mutex> lock(instance->mutex);
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue("isPlayingStateUpdate")},
+      {flutter::EncodableValue("isPlaying"),
+       flutter::EncodableValue(is_playing)}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendPlaylistItemChangedEventMessage(
+    FlutterVideoPlayer* instance, int32_t index) {
+  std::lock_guard<std::mutex> lock(instance->mutex);
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue("playlistItemChanged")},
+      {flutter::EncodableValue("index"), flutter::EncodableValue(index)}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendPlaybackRateChangedEventMessage(
+    FlutterVideoPlayer* instance, double rate, const std::string& mode) {
+  std::lock_guard<std::mutex> lock(instance->mutex);
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue("playbackRateChanged")},
+      {flutter::EncodableValue("rate"), flutter::EncodableValue(rate)},
+      {flutter::EncodableValue("mode"), flutter::EncodableValue(mode)}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendResizedEventMessage(FlutterVideoPlayer* instance,
+                                                int32_t width, int32_t height) {
+  std::lock_guard<std::mutex> lock(instance->mutex);
+  if (!instance->event_sink) {
+    return;
+  }
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"), flutter::EncodableValue("resized")},
+      {flutter::EncodableValue("width"), flutter::EncodableValue(width)},
+      {flutter::EncodableValue("height"), flutter::EncodableValue(height)}};
+  flutter::EncodableValue event(encodables);
+  instance->event_sink->Success(event);
+}
+
+void VideoPlayerPlugin::SendErrorEventMessage(FlutterVideoPlayer* instance,
+                                              const std::string& message) {
+  std::lock_guard<std::mutex> lock(instance->mutex);
+  if (!instance->event_sink) {
+    // Sent when the event channel is listened to.
+    instance->error = message;
+    return;
+  }
+
+  instance->event_sink->Error(kVideoPlayerErrorCode, message);
 }
 
 flutter::EncodableValue VideoPlayerPlugin::WrapError(
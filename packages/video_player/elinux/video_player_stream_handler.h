@@ -5,6 +5,9 @@
 #ifndef PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_H_
 #define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_H_
 
+#include <cstdint>
+#include <string>
+
 class VideoPlayerStreamHandler {
  public:
   VideoPlayerStreamHandler() = default;
@@ -23,10 +26,49 @@ class VideoPlayerStreamHandler {
   // Notifies the completion of playing a video.
   void OnNotifyCompleted() { OnNotifyCompletedInternal(); }
 
+  // Notifies the start or the end of buffering a network stream.
+  void OnNotifyBufferingStateChanged(bool is_buffering) {
+    OnNotifyBufferingStateChangedInternal(is_buffering);
+  }
+
+  // Notifies whether the video player started or stopped playing.
+  void OnNotifyPlayingStateChanged(bool is_playing) {
+    OnNotifyPlayingStateChangedInternal(is_playing);
+  }
+
+  // Notifies that the item at |index| of the playlist started playing.
+  void OnNotifyPlaylistItemChanged(int32_t index) {
+    OnNotifyPlaylistItemChangedInternal(index);
+  }
+
+  // Notifies that the playback rate changed to |rate|, and how it is applied:
+  // "instant", "flush", "reverse" or "reverseKeyUnits".
+  void OnNotifyPlaybackRateChanged(double rate, const std::string& mode) {
+    OnNotifyPlaybackRateChangedInternal(rate, mode);
+  }
+
+  // Notifies that the size of the video changed to |width| x |height| after
+  // the initialization, e.g. when an adaptive stream switches its variant.
+  void OnNotifyResized(int32_t width, int32_t height) {
+    OnNotifyResizedInternal(width, height);
+  }
+
+  // Notifies an error which stops the video player.
+  void OnNotifyError(const std::string& message) {
+    OnNotifyErrorInternal(message);
+  }
+
  protected:
   virtual void OnNotifyInitializedInternal() = 0;
   virtual void OnNotifyFrameDecodedInternal() = 0;
   virtual void OnNotifyCompletedInternal() = 0;
+  virtual void OnNotifyBufferingStateChangedInternal(bool is_buffering) = 0;
+  virtual void OnNotifyPlayingStateChangedInternal(bool is_playing) = 0;
+  virtual void OnNotifyPlaylistItemChangedInternal(int32_t index) = 0;
+  virtual void OnNotifyPlaybackRateChangedInternal(double rate,
+                                                   const std::string& mode) = 0;
+  virtual void OnNotifyResizedInternal(int32_t width, int32_t height) = 0;
+  virtual void OnNotifyErrorInternal(const std::string& message) = 0;
 };
 
 #endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_H_
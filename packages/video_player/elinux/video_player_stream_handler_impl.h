@@ -6,6 +6,7 @@
 #define PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_IMPL_H_
 
 #include <functional>
+#include <string>
 
 #include "video_player_stream_handler.h"
 
@@ -14,13 +15,32 @@ class VideoPlayerStreamHandlerImpl : public VideoPlayerStreamHandler {
   using OnNotifyInitialized = std::function<void()>;
   using OnNotifyFrameDecoded = std::function<void()>;
   using OnNotifyCompleted = std::function<void()>;
+  using OnNotifyBufferingStateChanged = std::function<void(bool)>;
+  using OnNotifyPlayingStateChanged = std::function<void(bool)>;
+  using OnNotifyPlaylistItemChanged = std::function<void(int32_t)>;
+  using OnNotifyPlaybackRateChanged =
+      std::function<void(double, const std::string&)>;
+  using OnNotifyResized = std::function<void(int32_t, int32_t)>;
+  using OnNotifyError = std::function<void(const std::string&)>;
 
-  VideoPlayerStreamHandlerImpl(OnNotifyInitialized on_notify_initialized,
-                               OnNotifyFrameDecoded on_notify_frame_decoded,
-                               OnNotifyCompleted on_notify_completed)
+  VideoPlayerStreamHandlerImpl(
+      OnNotifyInitialized on_notify_initialized,
+      OnNotifyFrameDecoded on_notify_frame_decoded,
+      OnNotifyCompleted on_notify_completed,
+      OnNotifyBufferingStateChanged on_notify_buffering_state_changed,
+      OnNotifyPlayingStateChanged on_notify_playing_state_changed,
+      OnNotifyPlaylistItemChanged on_notify_playlist_item_changed,
+      OnNotifyPlaybackRateChanged on_notify_playback_rate_changed,
+      OnNotifyResized on_notify_resized, OnNotifyError on_notify_error)
       : on_notify_initialized_(on_notify_initialized),
         on_notify_frame_decoded_(on_notify_frame_decoded),
-        on_notify_completed_(on_notify_completed) {}
+        on_notify_completed_(on_notify_completed),
+        on_notify_buffering_state_changed_(on_notify_buffering_state_changed),
+        on_notify_playing_state_changed_(on_notify_playing_state_changed),
+        on_notify_playlist_item_changed_(on_notify_playlist_item_changed),
+        on_notify_playback_rate_changed_(on_notify_playback_rate_changed),
+        on_notify_resized_(on_notify_resized),
+        on_notify_error_(on_notify_error) {}
   virtual ~VideoPlayerStreamHandlerImpl() = default;
 
   // Prevent copying.
@@ -50,9 +70,58 @@ class VideoPlayerStreamHandlerImpl : public VideoPlayerStreamHandler {
     }
   }
 
+  // |VideoPlayerStreamHandler|
+  void OnNotifyBufferingStateChangedInternal(bool is_buffering) {
+    if (on_notify_buffering_state_changed_) {
+      on_notify_buffering_state_changed_(is_buffering);
+    }
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlayingStateChangedInternal(bool is_playing) {
+    if (on_notify_playing_state_changed_) {
+      on_notify_playing_state_changed_(is_playing);
+    }
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlaylistItemChangedInternal(int32_t index) {
+    if (on_notify_playlist_item_changed_) {
+      on_notify_playlist_item_changed_(index);
+    }
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyPlaybackRateChangedInternal(double rate,
+                                           const std::string& mode) {
+    if (on_notify_playback_rate_changed_) {
+      on_notify_playback_rate_changed_(rate, mode);
+    }
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyResizedInternal(int32_t width, int32_t height) {
+    if (on_notify_resized_) {
+      on_notify_resized_(width, height);
+    }
+  }
+
+  // |VideoPlayerStreamHandler|
+  void OnNotifyErrorInternal(const std::string& message) {
+    if (on_notify_error_) {
+      on_notify_error_(message);
+    }
+  }
+
   OnNotifyInitialized on_notify_initialized_;
   OnNotifyFrameDecoded on_notify_frame_decoded_;
   OnNotifyCompleted on_notify_completed_;
+  OnNotifyBufferingStateChanged on_notify_buffering_state_changed_;
+  OnNotifyPlayingStateChanged on_notify_playing_state_changed_;
+  OnNotifyPlaylistItemChanged on_notify_playlist_item_changed_;
+  OnNotifyPlaybackRateChanged on_notify_playback_rate_changed_;
+  OnNotifyResized on_notify_resized_;
+  OnNotifyError on_notify_error_;
 };
 
 #endif  // PACKAGES_VIDEO_PLAYER_VIDEO_PLAYER_ELINUX_VIDEO_PLAYER_STREAM_HANDLER_IMPL_H_